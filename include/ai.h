@@ -7,38 +7,136 @@
  * 2. 范围限制：在对手上次落子附近的小范围内搜索，减少搜索空间
  * 3. 修改UCT公式：随着访问次数增加动态调整探索权重
  * 4. 前几步特殊处理：首步采用天元或星位等策略性位置
- * 5. 减少模拟深度：不模拟到游戏结束，而是运行有限步数
+ * 5. 自然终局：模拟中双方都不填自己的单点眼，下到双方连续停一手为止，按数子法加贴目判定胜负
  * 6. 局部搜索：优先在有意义的位置搜索，如已有棋子附近
- * 7. 提前终止：如果多步无提子，提前结束模拟
- * 8. 渐进式扩展：增加随机探索的概率以避免局部最优
+ * 7. 快速选点：模拟中先试记住的获胜应手，再优先吃子、逃子和应对上一手的3×3模式，其余从轻量棋盘的空点表中随机抽取（见 playout.h）
+ * 8. 渐进式扩展：子节点按先验概率（吃子、叫吃、逃子、与最近两手的距离、3×3模式）排序，
+ *    只有前几个参与选择，父节点访问次数增长时再逐个放开；先验概率同时作为UCT的偏置项
  */
 
 #ifndef AI_H
 #define AI_H
 
 #include "board.h"
+#include "playout.h"
+#include "rng.h"
+#include "transposition.h"
+#include <SDL2/SDL.h>
 
 // 前向声明
 typedef struct Game Game;
 
-// 蒙特卡洛树节点
+// 一次迭代最多经过的节点数，超出时在该处停止选择
+#define MCTS_MAX_PATH 256
+
+// 一次模拟最多记录的落子数
+#define MCTS_MAX_PLAYOUT_MOVES (BOARD_SIZE * BOARD_SIZE * 2)
+
+// 一次计算UCT值的候选落子数（AVX 寄存器可放8个单精度数），候选落子表的数组长度按它补齐
+#define MCTS_CHILD_LANES 8
+
+// 节点扩展状态
+typedef enum {
+    NODE_LEAF,                    // 尚未扩展
+    NODE_EXPANDING,               // 某个线程正在扩展
+    NODE_EXPANDED                 // 子节点已就绪
+} NodeState;
+
+// 蒙特卡洛树节点（统计量由多个搜索线程并发更新）
 typedef struct MCTSNode {
-    Position move;                // 此节点对应的落子位置
-    Stone player;                 // 此节点对应的玩家
-    int visits;                   // 访问次数
-    double wins;                  // 胜利次数
-    int childrenCount;            // 子节点数量
-    struct MCTSNode** children;   // 子节点数组
-    struct MCTSNode* parent;      // 父节点
+    int move;                     // 从 parent 走到此节点的落子格点（相同局面也可能经其他落子到达）
+    Stone player;                 // 此节点局面的行棋方（走出 move 的是对方）
+    SDL_atomic_t visits;          // 局面的访问次数（各条来路之和，选择经过时即加一）
+    SDL_atomic_t state;           // 扩展状态（NodeState），扩展前用CAS抢占
+    int childrenCount;            // 候选落子数量（state 为 NODE_EXPANDED 后才有效）
+    struct MCTSChildren* children; // 候选落子表（在节点池中连续存放，按先验概率从大到小排列）
+    struct MCTSNode* parent;      // 父节点（第一次创建时的来路，置换节点可能还有其他来路）
+    uint64_t key;                 // 局面键（见 positionKey）
 } MCTSNode;
 
+// 候选落子表：已扩展节点的每个候选落子（即通向子节点的边）的统计按字段分别连续存放，
+// 选择时可以一次计算一组候选落子的UCT值。各数组紧跟在表头之后，长度补齐到 MCTS_CHILD_LANES 的倍数，
+// 补齐部分全为0；子节点在第一次被选中时才创建。
+// 四项统计是普通的 int 数组，搜索期间只用 relaxed 顺序的 __atomic 内建函数读写（见 ai.c 的 addChildStat、getChildStat），
+// 每个计数不会丢失更新，同时读到的几个计数之间不保证一致
+typedef struct MCTSChildren {
+    int stride;                   // 每个数组的长度
+    int* moves;                   // 落子格点
+    float* priors;                // 启发式先验概率（兄弟之和为1）
+    int* visits;                  // 这条边的访问次数（选择经过时即加一，模拟结束前相当于一次虚拟损失）
+    int* wins;                    // 这条边的胜利次数（从走出落子的一方计算）
+    int* amafVisits;              // AMAF 次数：这一落子在之后由同一方先下过的模拟次数
+    int* amafWins;                // AMAF 胜利次数
+    struct MCTSNode** nodes;      // 子节点（尚未创建时为 NULL，创建后用CAS发布；相同局面的边指向同一个节点）
+} MCTSChildren;
+
+// 节点池：搜索期间按块分配节点和候选落子表，搜索结束后整体重置
+typedef struct {
+    MCTSNode* nodes;              // 节点存储
+    int capacity;                 // 总节点数
+    SDL_atomic_t used;            // 已分配节点数（多个搜索线程并发分配）
+    unsigned char* childData;     // 候选落子表存储
+    int childCapacity;            // 候选落子表存储的字节数
+    SDL_atomic_t childrenUsed;    // 已分配的字节数
+    TranspositionTable* table;    // 扩展时使用的置换表（可为 NULL，由搜索树负责清空）
+} NodeArena;
+
+// 跨回合保留的搜索树：两个节点池轮流使用，提升子树时把它紧凑地复制到另一个池中
+typedef struct {
+    NodeArena arenas[2];          // 节点池
+    int activeArena;              // 当前树所在的节点池
+    MCTSNode* root;               // 根节点（没有树时为 NULL）
+    int rootMoveNumber;           // 根节点局面的手数
+    uint64_t rootHash;            // 根节点局面的哈希
+    TranspositionTable table;     // 当前树的置换表
+} SearchTree;
+
+// 多线程搜索方式
+typedef enum {
+    PARALLEL_TREE,                // 树并行：所有线程共享一棵树
+    PARALLEL_ROOT                 // 根并行：每个线程一棵独立的树，结束时合并统计
+} ParallelMode;
+
+// 模拟落子策略
+typedef enum {
+    PLAYOUT_LIGHT,                // 轻模拟：在空点中均匀随机落子（不填自己的眼）
+    PLAYOUT_HEAVY                 // 重模拟：依次尝试吃子、逃子、最后一手周围的3×3模式，都没有时再随机
+} PlayoutPolicy;
+
 // AI配置
 typedef struct {
     int simulationCount;          // 每步模拟次数
     double explorationParameter;  // UCT探索参数
     int maxDepth;                 // 最大搜索深度
+    Uint32 timeLimit;             // 每次搜索的时间限制（毫秒）
+    int threadCount;              // 搜索线程数
+    ParallelMode parallelMode;    // 多线程搜索方式
+    uint64_t seed;                // 随机数种子（0 表示每次搜索另取种子；固定种子的单线程搜索可逐位重现）
+    int transpositionMB;          // 置换表内存上限（MB，0 表示不使用置换表）
+    double raveEquivalence;       // RAVE 等价访问次数（访问次数达到它的三分之一时两种胜率各占一半，0 表示不使用 RAVE）
+    double komi;                  // 贴目（模拟终局按数子法计算胜负，白方加上贴目）
+    PlayoutPolicy playoutPolicy;  // 模拟落子策略
+    bool lastGoodReply;           // 模拟中优先使用之前获胜过的应手（LGRF）
+    int wideningBase;             // 渐进式扩展：一开始参与选择的子节点数，之后随访问次数逐个放开（0 表示不限制）
+    double priorWeight;           // 先验概率在UCT中的权重（PUCT）
 } AIConfig;
 
+// 应手表（LGRF）：按行棋方和对方上一手记录在之前的模拟中带来胜利的应手
+// 每次搜索开始时清空，所有搜索线程共享；每项只是一个原子整数，读写无需加锁
+typedef struct {
+    SDL_atomic_t replies[2][BOARD_VERTICES]; // [行棋方 - BLACK][对方上一手] -> 应手（NO_VERTEX 表示无）
+} ReplyTable;
+
+// 单个搜索线程的上下文
+typedef struct {
+    AIConfig* config;             // AI配置
+    Rng rng;                      // 线程独占的随机数生成器
+    ReplyTable* replies;          // 本次搜索共享的应手表（NULL 表示不使用）
+    MCTSNode* path[MCTS_MAX_PATH]; // 本次迭代经过的节点，反向传播沿它更新
+    int edges[MCTS_MAX_PATH];     // 到达 path 中各节点所走的边（在上一个节点候选落子表中的下标，根节点为 -1）
+    int pathLength;               // 经过的节点数
+} SearchContext;
+
 /**
  * @brief 初始化AI配置
  * @param config AI配置指针
@@ -46,80 +144,196 @@ typedef struct {
 void initAIConfig(AIConfig* config);
 
 /**
- * @brief 创建MCTS根节点
+ * @brief 初始化节点池
+ * @param arena 节点池指针
+ * @param capacity 最多可分配的节点数（候选落子的容量按它的固定倍数分配）
+ * @return 是否成功
+ */
+bool initNodeArena(NodeArena* arena, int capacity);
+
+/**
+ * @brief 释放节点池的存储
+ * @param arena 节点池指针
+ */
+void freeNodeArena(NodeArena* arena);
+
+/**
+ * @brief 重置节点池，一次性丢弃其中的整棵树
+ * @param arena 节点池指针
+ */
+void resetNodeArena(NodeArena* arena);
+
+/**
+ * @brief 检查节点池是否已用满（剩余空间不足以保证再扩展一个节点）
+ * @param arena 节点池指针
+ * @return 是否已满
+ */
+bool nodeArenaFull(NodeArena* arena);
+
+/**
+ * @brief 初始化搜索树
+ * @param tree 搜索树指针
+ * @param config AI配置（决定置换表的内存上限）
+ * @return 是否成功
+ */
+bool initSearchTree(SearchTree* tree, AIConfig* config);
+
+/**
+ * @brief 释放搜索树的存储
+ * @param tree 搜索树指针
+ */
+void freeSearchTree(SearchTree* tree);
+
+/**
+ * @brief 丢弃整棵搜索树
+ * @param tree 搜索树指针
+ */
+void clearSearchTree(SearchTree* tree);
+
+/**
+ * @brief 让搜索树跟上棋盘的当前局面
+ *
+ * 如果棋盘是从上次的根局面沿历史记录走下来的，并且这些落子都能在树中找到，
+ * 就把对应的子树提升为新根并保留其统计；否则丢弃旧树，新建根节点。
+ * @param tree 搜索树指针
  * @param board 当前棋盘状态
- * @return 创建的根节点
+ * @return 新的根节点（节点池不可用时为 NULL）
  */
-MCTSNode* createRootNode(Board* board);
+MCTSNode* advanceSearchTree(SearchTree* tree, Board* board);
 
 /**
- * @brief 释放MCTS树
- * @param node 要释放的节点
+ * @brief 创建MCTS根节点
+ * @param arena 节点池指针
+ * @param board 当前棋盘状态
+ * @return 创建的根节点（节点池已满时为 NULL）
  */
-void freeMCTSTree(MCTSNode* node);
+MCTSNode* createRootNode(NodeArena* arena, Board* board);
 
 /**
  * @brief 使用蒙特卡洛树搜索选择最佳落子位置
+ * @param tree 搜索树（保留到下一回合复用）
+ * @param board 当前棋盘状态
+ * @param config AI配置
+ * @return 最佳落子格点（没有可下的位置时为 NO_VERTEX）
+ */
+int findBestMove(SearchTree* tree, Board* board, AIConfig* config);
+
+/**
+ * @brief 开局时从天元和星位中随机选择一个落子
  * @param board 当前棋盘状态
+ * @param config AI配置（提供随机数种子）
+ * @return 落子格点（不是第一步或没有可下的位置时为 NO_VERTEX）
+ */
+int chooseOpeningMove(Board* board, AIConfig* config);
+
+/**
+ * @brief 搜索结束后按完整规则从根节点选出落子，搜索失败时随机选择合法位置
+ * @param tree 搜索树（根节点应为当前局面）
+ * @param board 当前棋盘状态
+ * @param config AI配置
+ * @return 落子格点（没有可下的位置时为 NO_VERTEX）
+ */
+int pickSearchMove(SearchTree* tree, Board* board, AIConfig* config);
+
+/**
+ * @brief 在根局面上反复执行搜索迭代，直到达到次数、时间限制、收到停止请求或节点池用满
+ *
+ * 按 config->threadCount 启动辅助线程与调用线程一起搜索，迭代次数上限由所有线程共享，
+ * 返回前等待辅助线程全部结束。树并行时所有线程都在 root 所在的树上搜索；
+ * 根并行时辅助线程各自搜索一棵临时的树，结束后把它们的统计按落子逐层合并到 root 所在的树。
+ * @param rootBoard 根局面
  * @param config AI配置
- * @return 最佳落子位置
+ * @param arena 节点池指针
+ * @param root 根节点
+ * @param maxIterations 最多迭代次数
+ * @param timeLimit 时间限制（毫秒，0 表示不限）
+ * @param stop 停止请求标志（可为 NULL）
+ * @param playouts 模拟次数计数，每次迭代加一（可为 NULL）
+ * @param treeFull 节点池用满时置位并结束搜索（可为 NULL，此时用满后继续模拟）
+ * @return 完成的迭代次数
  */
-Position findBestMove(Board* board, AIConfig* config);
+int runMCTSIterations(const PlayoutBoard* rootBoard, AIConfig* config, NodeArena* arena, MCTSNode* root,
+                      int maxIterations, Uint32 timeLimit, SDL_atomic_t* stop, SDL_atomic_t* playouts,
+                      SDL_atomic_t* treeFull);
 
 /**
  * @brief 执行一次蒙特卡洛树搜索
  * @param board 当前棋盘状态
  * @param config AI配置
+ * @param arena 节点池指针
  * @param root 根节点
  */
-void runMCTS(Board* board, AIConfig* config, MCTSNode* root);
+void runMCTS(Board* board, AIConfig* config, NodeArena* arena, MCTSNode* root);
 
 /**
- * @brief 选择阶段 - 选择最有前途的节点
+ * @brief 选择阶段 - 选择最有前途的节点（沿途节点的访问次数立即加一）
+ *
+ * 经过的节点和边记录在 ctx->path 和 ctx->edges 中，边和子节点的访问次数都加一。
+ * 每层把已放开的候选落子的统计读到局部缓冲区后用 SIMD 指令成组计算UCT值，父节点的对数和平方根只算一次。
+ * 选中的候选落子还没有子节点时在节点池中创建，节点池已满时停在当前节点。
+ * @param arena 节点池指针
  * @param node 当前节点
- * @param config AI配置
+ * @param ctx 搜索线程上下文
+ * @param pb 当前节点的局面（沿途落子，返回时为所选节点的局面）
  * @return 选择的节点
  */
-MCTSNode* selectNode(MCTSNode* node, AIConfig* config);
+MCTSNode* selectNode(NodeArena* arena, MCTSNode* node, SearchContext* ctx, PlayoutBoard* pb);
 
 /**
  * @brief 扩展阶段 - 扩展选择的节点
+ *
+ * 只有抢到扩展权的线程写入候选落子表，并只为先验概率最高的落子创建子节点；
+ * 其他线程正在扩展时直接返回该节点本身。节点池附带置换表时，
+ * 局面已经在树中出现过的候选落子直接指向已有节点，这条边的统计仍然单独记录。
+ * @param arena 节点池指针
  * @param node 要扩展的节点
- * @param board 当前棋盘状态
- * @return 新创建的子节点
+ * @param pb 要扩展节点的局面（返回时为所返回节点的局面）
+ * @param ctx 搜索线程上下文
+ * @return 新创建的子节点（其访问次数已加一）
  */
-MCTSNode* expandNode(MCTSNode* node, Board* board);
+MCTSNode* expandNode(NodeArena* arena, MCTSNode* node, PlayoutBoard* pb, SearchContext* ctx);
 
 /**
  * @brief 模拟阶段 - 从给定节点开始随机模拟到游戏结束
+ *
+ * 模拟结束后按结果更新应手表：记下获胜一方的应手，忘掉落败一方用过的应手。
  * @param node 开始模拟的节点
- * @param board 当前棋盘状态
- * @param config AI配置
- * @return 模拟结果（胜利为1，失败为0）
+ * @param pb 开始模拟节点的局面（模拟过程中会被修改）
+ * @param ctx 搜索线程上下文
+ * @param moves 模拟中依次走出的落子（输出，容量至少为 MCTS_MAX_PLAYOUT_MOVES）
+ * @param moveCount 落子数量（输出）
+ * @return 模拟结果（按数子法加贴目判定，node 的行棋方胜利为1，失败为0）
  */
-double simulateGame(MCTSNode* node, Board* board, AIConfig* config);
+double simulateGame(MCTSNode* node, PlayoutBoard* pb, SearchContext* ctx, int* moves, int* moveCount);
 
 /**
- * @brief 反向传播阶段 - 更新节点统计信息
- * @param node 开始更新的节点
+ * @brief 反向传播阶段 - 沿本次迭代经过的边更新胜利次数（访问次数已在选择阶段计入）
+ *
+ * 每条边的胜利次数记给走出这一步的一方，父节点选择子节点时比较的就是自己的胜率。
+ *
+ * 同时更新路径上各节点的子节点的 AMAF 统计：子节点的落子在这之后（树中或模拟中）
+ * 由同一方先下过，就按这次模拟的结果计入。
+ * @param ctx 搜索线程上下文（最后一个节点是开始模拟的节点）
  * @param result 模拟结果
+ * @param moves 模拟中依次走出的落子
+ * @param moveCount 落子数量
  */
-void backpropagate(MCTSNode* node, double result);
+void backpropagate(SearchContext* ctx, double result, const int* moves, int moveCount);
 
 /**
- * @brief 根据UCT值选择最佳子节点
+ * @brief 选择访问次数最多的候选落子
  * @param node 父节点
  * @param config AI配置
- * @return 最佳子节点
+ * @return 候选落子在 node->children 中的下标（没有访问过的候选落子时为 -1）
  */
-MCTSNode* selectBestChild(MCTSNode* node, AIConfig* config);
+int selectBestChild(MCTSNode* node, AIConfig* config);
 
 /**
  * @brief 获取所有合法落子位置
  * @param board 当前棋盘状态
- * @param positions 位置数组（输出）
+ * @param moves 格点数组（输出）
  * @return 合法落子位置数量
  */
-int getLegalMoves(Board* board, Position* positions);
+int getLegalMoves(Board* board, int* moves);
 
 #endif // AI_H
\ No newline at end of file
@@ -0,0 +1,106 @@
+/**
+ * @file bitboard.h
+ * @brief 位棋盘（每个格点一位）及按位并行的膨胀/填充操作
+ *
+ * 位编号与 board.h 中的一维格点编号一致，因此相邻格点就是 ±1 和 ±BOARD_STRIDE 位，
+ * 只需与棋盘内掩码相与即可去掉越界的位。
+ */
+
+// 位棋盘后端下 board.h 会反过来包含本文件，因此先于头文件保护包含 board.h
+#include "board.h"
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+// 覆盖全部格点所需的64位字数
+#define BITBOARD_WORDS ((BOARD_VERTICES + 63) / 64)
+
+// 位棋盘
+typedef struct {
+    uint64_t w[BITBOARD_WORDS];
+} Bitboard;
+
+/**
+ * @brief 初始化位棋盘常量表（棋盘内掩码），可重复调用
+ */
+void initBitboardTables(void);
+
+/**
+ * @brief 获取棋盘内全部格点的掩码
+ * @return 掩码指针
+ */
+const Bitboard* bbOnBoard(void);
+
+/**
+ * @brief 计算相邻格点集合（不含自身，限制在棋盘内）
+ * @param b 输入位棋盘
+ * @param out 输出位棋盘
+ */
+void bbNeighbors(const Bitboard* b, Bitboard* out);
+
+/**
+ * @brief 在掩码范围内从种子出发反复膨胀，直到不再变化
+ * @param seed 起始位棋盘
+ * @param mask 允许扩散的范围
+ * @param out 输出位棋盘（种子所在的连通区域）
+ */
+void bbFloodFill(const Bitboard* seed, const Bitboard* mask, Bitboard* out);
+
+static inline void bbClear(Bitboard* b) {
+    for (int i = 0; i < BITBOARD_WORDS; i++) b->w[i] = 0;
+}
+
+static inline void bbSetBit(Bitboard* b, int vertex) {
+    b->w[vertex >> 6] |= 1ULL << (vertex & 63);
+}
+
+static inline void bbClearBit(Bitboard* b, int vertex) {
+    b->w[vertex >> 6] &= ~(1ULL << (vertex & 63));
+}
+
+static inline bool bbTestBit(const Bitboard* b, int vertex) {
+    return (b->w[vertex >> 6] >> (vertex & 63)) & 1;
+}
+
+static inline void bbAnd(const Bitboard* a, const Bitboard* b, Bitboard* out) {
+    for (int i = 0; i < BITBOARD_WORDS; i++) out->w[i] = a->w[i] & b->w[i];
+}
+
+static inline void bbOr(const Bitboard* a, const Bitboard* b, Bitboard* out) {
+    for (int i = 0; i < BITBOARD_WORDS; i++) out->w[i] = a->w[i] | b->w[i];
+}
+
+static inline void bbAndNot(const Bitboard* a, const Bitboard* b, Bitboard* out) {
+    for (int i = 0; i < BITBOARD_WORDS; i++) out->w[i] = a->w[i] & ~b->w[i];
+}
+
+static inline bool bbIsZero(const Bitboard* b) {
+    uint64_t any = 0;
+    for (int i = 0; i < BITBOARD_WORDS; i++) any |= b->w[i];
+    return any == 0;
+}
+
+static inline bool bbIntersects(const Bitboard* a, const Bitboard* b) {
+    uint64_t any = 0;
+    for (int i = 0; i < BITBOARD_WORDS; i++) any |= a->w[i] & b->w[i];
+    return any != 0;
+}
+
+static inline int bbPopCount(const Bitboard* b) {
+    int count = 0;
+    for (int i = 0; i < BITBOARD_WORDS; i++) count += __builtin_popcountll(b->w[i]);
+    return count;
+}
+
+/**
+ * @brief 获取编号最小的置位格点
+ * @return 格点编号（位棋盘为空时返回 NO_VERTEX）
+ */
+static inline int bbFirstBit(const Bitboard* b) {
+    for (int i = 0; i < BITBOARD_WORDS; i++) {
+        if (b->w[i]) return i * 64 + __builtin_ctzll(b->w[i]);
+    }
+    return NO_VERTEX;
+}
+
+#endif // BITBOARD_H
\ No newline at end of file
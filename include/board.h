@@ -9,41 +9,88 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // 棋盘大小
 #define BOARD_SIZE 19
+// 带边界哨兵的一维棋盘行宽（四周各留一圈 OFFBOARD）
+#define BOARD_STRIDE (BOARD_SIZE + 2)
+// 一维棋盘的格点总数
+#define BOARD_VERTICES (BOARD_STRIDE * BOARD_STRIDE)
+
+// 坐标与一维格点编号之间的转换
+#define VERTEX(x, y) (((y) + 1) * BOARD_STRIDE + (x) + 1)
+#define VERTEX_X(v) ((v) % BOARD_STRIDE - 1)
+#define VERTEX_Y(v) ((v) / BOARD_STRIDE - 1)
+// 无效格点（位于哨兵边界上，永远不会是棋盘内的点）
+#define NO_VERTEX 0
 
 // 棋子颜色
 typedef enum {
-    EMPTY = 0,  // 空位
-    BLACK = 1,  // 黑棋
-    WHITE = 2   // 白棋
+    EMPTY = 0,   // 空位
+    BLACK = 1,   // 黑棋
+    WHITE = 2,   // 白棋
+    OFFBOARD = 3 // 棋盘外的哨兵
 } Stone;
 
-// 棋盘位置
+// 棋盘位置（仅用于图形界面的坐标换算）
 typedef struct {
     int x;  // 横坐标 (0-18)
     int y;  // 纵坐标 (0-18)
 } Position;
 
-// 棋盘历史记录节点（双向链表）
-typedef struct BoardHistoryNode {
-    Stone board[BOARD_SIZE][BOARD_SIZE];  // 棋盘状态
-    Position lastMove;                    // 最后一步落子位置
+// 贴目：数子法终局时白方加上的目数（对局判定和搜索模拟共用）
+#define KOMI 4.5
+
+// 四个相邻方向的格点编号偏移
+extern const int NEIGHBOR_OFFSETS[4];
+
+// 本局局面哈希集合的初始槽数（2的幂，开放寻址，超过四分之三时槽数加倍）
+#ifndef POSITION_SET_SIZE
+#define POSITION_SET_SIZE 2048
+#endif
+
+// Zobrist 随机数表（按棋子颜色和格点索引）
+extern uint64_t zobristKeys[3][BOARD_VERTICES];
+
+// 棋盘后端：默认使用增量维护的棋子组表，定义 BOARD_BITBOARD 时改用位棋盘
+#ifdef BOARD_BITBOARD
+#include "bitboard.h"
+#else
+#include "groups.h"
+#endif
+
+// 历史记录中每隔多少手保存一份完整棋盘（关键帧）
+#define HISTORY_KEYFRAME_INTERVAL 32
+
+// 历史关键帧：完整的棋子分布和提子数
+typedef struct {
+    uint8_t board[BOARD_VERTICES];        // 棋盘状态
     int blackCaptures;                    // 黑方提子数
     int whiteCaptures;                    // 白方提子数
-    int blackLiberties;                   // 黑方气数
-    int whiteLiberties;                   // 白方气数
+} BoardKeyframe;
+
+// 棋盘历史记录节点（双向链表），只记录本手的变化
+typedef struct BoardHistoryNode {
     struct BoardHistoryNode* prev;        // 前一个节点
     struct BoardHistoryNode* next;        // 后一个节点
+    BoardKeyframe* keyframe;              // 本手之后的完整棋盘（仅关键帧节点有，其余为 NULL）
+    uint64_t hash;                        // 本手之后的局面哈希
+    int moveNumber;                       // 手数（头节点为 0）
+    int16_t move;                         // 落子格点（头节点为 NO_VERTEX）
+    int16_t koPosition;                   // 本手之后的打劫位置
+    uint8_t color;                        // 落子方（头节点为 EMPTY）
+    bool koActive;                        // 本手之后是否存在打劫
+    int16_t capturedCount;                // 本手提子数
+    int16_t captured[];                   // 被提棋子的格点
 } BoardHistory;
 
 // 棋盘结构
 typedef struct {
-    Stone board[BOARD_SIZE][BOARD_SIZE];  // 当前棋盘状态
+    uint8_t board[BOARD_VERTICES];        // 当前棋盘状态（Stone 值，含 OFFBOARD 边界）
     Stone currentPlayer;                  // 当前玩家
-    Position lastMove;                    // 最后一步落子位置
-    Position koPosition;                  // 打劫位置
+    int lastMove;                         // 最后一步落子位置
+    int koPosition;                       // 打劫位置
     bool koActive;                        // 是否存在打劫
     int blackCaptures;                    // 黑方提子数
     int whiteCaptures;                    // 白方提子数
@@ -51,8 +98,27 @@ typedef struct {
     int whiteLiberties;                   // 白方气数
     BoardHistory* history;                // 历史记录头节点
     BoardHistory* current;                // 当前历史记录节点
+    
+    // 局面哈希（只与棋子分布有关，落子和提子时增量更新）
+    uint64_t hash;                        // 当前局面的 Zobrist 哈希
+    uint64_t* seenPositions;              // 当前棋局路线上出现过的局面（0 为空槽）
+    int seenCapacity;                     // 局面集合的槽数
+    int seenCount;                        // 已记录的局面数
+    
+#ifdef BOARD_BITBOARD
+    // 位棋盘（按颜色索引，落子时同步更新）
+    Bitboard stones[3];                   // stones[BLACK] 和 stones[WHITE] 有效
+#else
+    // 棋子组表（按格点编号索引，落子时增量维护）
+    GroupTable groups;
+#endif
 } Board;
 
+/**
+ * @brief 初始化 Zobrist 随机数表（固定种子，可重复调用）
+ */
+void initZobrist(void);
+
 /**
  * @brief 初始化棋盘
  * @param board 棋盘指针
@@ -68,58 +134,58 @@ void freeBoard(Board* board);
 /**
  * @brief 在指定位置落子
  * @param board 棋盘指针
- * @param pos 落子位置
+ * @param vertex 落子格点
  * @return 落子是否成功
  */
-bool placeStone(Board* board, Position pos);
+bool placeStone(Board* board, int vertex);
 
 /**
  * @brief 检查指定位置是否有气
  * @param board 棋盘指针
- * @param pos 位置
+ * @param vertex 格点
  * @return 是否有气
  */
-bool hasLiberty(Board* board, Position pos);
+bool hasLiberty(Board* board, int vertex);
 
 /**
  * @brief 计算棋子组的气数
  * @param board 棋盘指针
- * @param pos 起始位置
+ * @param vertex 起始格点
  * @return 气数
  */
-int countLiberties(Board* board, Position pos);
-
-/**
- * @brief 提取无气的棋子
- * @param board 棋盘指针
- * @param color 要检查的棋子颜色
- * @return 提取的棋子数量
- */
-int captureDeadStones(Board* board, Stone color);
+int countLiberties(Board* board, int vertex);
 
 /**
  * @brief 检查落子是否合法
  * @param board 棋盘指针
- * @param pos 落子位置
+ * @param vertex 落子格点
  * @return 是否合法
  */
-bool isValidMove(Board* board, Position pos);
+bool isValidMove(Board* board, int vertex);
 
 /**
  * @brief 检查是否是自杀行为
  * @param board 棋盘指针
- * @param pos 落子位置
+ * @param vertex 落子格点
  * @return 是否是自杀行为
  */
-bool isSuicideMove(Board* board, Position pos);
+bool isSuicideMove(Board* board, int vertex);
 
 /**
  * @brief 检查是否是打劫
  * @param board 棋盘指针
- * @param pos 落子位置
+ * @param vertex 落子格点
  * @return 是否是打劫
  */
-bool isKoMove(Board* board, Position pos);
+bool isKoMove(Board* board, int vertex);
+
+/**
+ * @brief 检查落子后是否会重复本局出现过的局面（全局同形）
+ * @param board 棋盘指针
+ * @param vertex 落子格点（应为空位）
+ * @return 是否违反全局同形禁着
+ */
+bool isSuperkoMove(Board* board, int vertex);
 
 /**
  * @brief 悔棋
@@ -135,6 +201,14 @@ bool undoMove(Board* board);
  */
 bool redoMove(Board* board);
 
+/**
+ * @brief 跳转到指定手数（从最近的关键帧开始重放）
+ * @param board 棋盘指针
+ * @param moveNumber 目标手数（0 表示开局）
+ * @return 是否成功（目标手数不在历史记录中时失败）
+ */
+bool gotoMove(Board* board, int moveNumber);
+
 /**
  * @brief 计算黑白双方的气数
  * @param board 棋盘指针
@@ -149,9 +223,50 @@ void calculateLiberties(Board* board);
 int determineWinner(Board* board);
 
 /**
- * @brief 保存当前棋盘状态到历史记录
+ * @brief 把刚下的一手追加到历史记录（会丢弃当前节点之后的分支）
+ * @param board 棋盘指针（已完成落子和提子，尚未交换行棋方）
+ * @param vertex 落子格点
+ * @param captured 被提棋子的格点
+ * @param capturedCount 提子数
+ */
+void saveBoardState(Board* board, int vertex, const int16_t* captured, int capturedCount);
+
+// 以下函数由所选的棋盘后端实现（board.c 或 board_bitboard.c），供 board.c 内部调用
+
+/**
+ * @brief 计算落子（含提子）后的局面哈希，不修改棋盘
+ * @param board 棋盘指针
+ * @param vertex 落子格点（应为空位）
+ * @param color 棋子颜色
+ * @return 落子后的局面哈希
+ */
+uint64_t hashAfterMove(Board* board, int vertex, Stone color);
+
+/**
+ * @brief 放置棋子并提取因此无气的对方棋子，同时更新双方气数和局面哈希
+ * @param board 棋盘指针
+ * @param vertex 落子格点（调用前已确认合法）
+ * @param color 棋子颜色
+ * @param captured 被提棋子的格点（输出，容量至少为 BOARD_SIZE * BOARD_SIZE）
+ * @return 提子数量
+ */
+int playStoneAndCapture(Board* board, int vertex, Stone color, int16_t* captured);
+
+/**
+ * @brief 根据 board 数组重建后端的派生数据（棋子组表或位棋盘）
+ * @param board 棋盘指针
+ */
+void rebuildBoardCache(Board* board);
+
+/**
+ * @brief 改变若干格点的棋子，只重新推导受影响的棋子组并按差值更新双方气数（悔棋和前进时使用）
+ *
+ * 局面哈希不在这里更新，由调用方从历史记录中恢复。
  * @param board 棋盘指针
+ * @param vertices 要改变的格点
+ * @param colors 各格点的新状态（EMPTY、BLACK 或 WHITE）
+ * @param count 格点数量
  */
-void saveBoardState(Board* board);
+void updateStones(Board* board, const int* vertices, const uint8_t* colors, int count);
 
 #endif // BOARD_H
\ No newline at end of file
@@ -0,0 +1,112 @@
+/**
+ * @file engine.h
+ * @brief AI引擎线程：在独立线程中执行搜索，不阻塞图形界面
+ *
+ * 主线程与引擎线程之间只有一个请求槽：主线程提交“搜索”或“后台思考”请求，
+ * 引擎线程完成搜索后记录完成的请求编号，由主线程取回结果并落子。
+ * 引擎忙碌时搜索树只由引擎线程访问；主线程提交新请求或读取结果前，
+ * 引擎总是处于空闲状态。
+ */
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "ai.h"
+
+// 引擎任务
+typedef enum {
+    ENGINE_TASK_NONE,    // 无任务
+    ENGINE_TASK_SEARCH,  // 在时间和次数限制内搜索，完成后给出结果
+    ENGINE_TASK_PONDER,  // 后台思考，直到被停止或节点池用满
+    ENGINE_TASK_QUIT     // 退出线程
+} EngineTask;
+
+// AI引擎
+typedef struct {
+    SDL_Thread* thread;           // 引擎线程
+    SDL_mutex* mutex;             // 保护请求槽和引擎状态
+    SDL_cond* cond;               // 请求到达或任务完成时通知
+    SearchTree tree;              // 搜索树（引擎空闲时主线程才能访问）
+    
+    // 请求槽（持锁访问）
+    EngineTask request;           // 待执行的任务
+    int requestId;                // 待执行任务的编号
+    PlayoutBoard rootBoard;       // 任务局面的快照
+    AIConfig config;              // AI配置
+    
+    // 引擎线程状态（持锁访问）
+    bool busy;                    // 是否正在执行任务
+    int finishedId;               // 最近完成的搜索任务编号
+    
+    SDL_atomic_t stop;            // 停止当前任务的请求
+    SDL_atomic_t playouts;        // 当前任务已完成的模拟次数
+    SDL_atomic_t treeFull;        // 后台思考是否因节点池用满而提前结束
+    
+    // 最近提交的任务（只由主线程访问）
+    EngineTask task;              // 任务类型
+    int taskMoveNumber;           // 任务局面的手数
+    uint64_t taskHash;            // 任务局面的哈希
+    int nextId;                   // 下一个任务编号
+} Engine;
+
+/**
+ * @brief 初始化引擎并启动引擎线程
+ * @param engine 引擎指针
+ * @return 是否成功
+ */
+bool initEngine(Engine* engine);
+
+/**
+ * @brief 停止引擎线程并释放资源
+ * @param engine 引擎指针
+ */
+void freeEngine(Engine* engine);
+
+/**
+ * @brief 为当前局面提交任务（会先停止正在执行的任务）
+ * @param engine 引擎指针
+ * @param task 任务类型（ENGINE_TASK_SEARCH 或 ENGINE_TASK_PONDER）
+ * @param board 当前棋盘状态
+ * @param config AI配置
+ * @return 任务编号（提交失败时为 0）
+ */
+int engineSubmit(Engine* engine, EngineTask task, Board* board, AIConfig* config);
+
+/**
+ * @brief 取消待执行和正在执行的任务，并等待引擎空闲（最多等待一次搜索迭代）
+ * @param engine 引擎指针
+ */
+void engineStop(Engine* engine);
+
+/**
+ * @brief 检查搜索任务是否已完成（完成后引擎空闲，可以读取搜索树）
+ * @param engine 引擎指针
+ * @param id 任务编号
+ * @return 是否已完成
+ */
+bool engineResultReady(Engine* engine, int id);
+
+/**
+ * @brief 检查最近提交的任务是否是指定局面上的指定任务
+ * @param engine 引擎指针
+ * @param task 任务类型
+ * @param board 棋盘状态
+ * @return 是否匹配
+ */
+bool engineTaskMatches(Engine* engine, EngineTask task, Board* board);
+
+/**
+ * @brief 获取当前任务已完成的模拟次数
+ * @param engine 引擎指针
+ * @return 模拟次数
+ */
+int enginePlayouts(Engine* engine);
+
+/**
+ * @brief 检查当前的后台思考是否因节点池用满而已经结束
+ * @param engine 引擎指针
+ * @return 是否已结束
+ */
+bool engineTreeFull(Engine* engine);
+
+#endif // ENGINE_H
\ No newline at end of file
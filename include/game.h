@@ -7,6 +7,7 @@
 #define GAME_H
 
 #include "board.h"
+#include "engine.h"
 
 // 游戏模式
 typedef enum {
@@ -25,6 +26,8 @@ typedef enum {
 // 游戏结构
 typedef struct Game {
     Board board;          // 棋盘
+    Engine engine;        // AI引擎（独立线程，搜索树跨回合复用）
+    int aiRequest;        // 等待结果的搜索任务编号（0 表示没有）
     GameMode mode;        // 游戏模式
     GameState state;      // 游戏状态
     bool showHints;       // 是否显示提示
@@ -47,25 +50,38 @@ void freeGame(Game* game);
 /**
  * @brief 处理玩家落子
  * @param game 游戏指针
- * @param pos 落子位置
+ * @param vertex 落子格点
  * @return 落子是否成功
  */
-bool handlePlayerMove(Game* game, Position pos);
+bool handlePlayerMove(Game* game, int vertex);
 
 /**
- * @brief 处理AI落子
+ * @brief 处理AI落子（人机模式下轮到AI时提交搜索，结果由 updateAI 落子）
  * @param game 游戏指针
- * @return 落子是否成功
+ * @return 是否已提交搜索或直接落子
  */
 bool handleAIMove(Game* game);
 
 /**
- * @brief 使用AI为当前玩家落子（无论黑白）
+ * @brief 使用AI为当前玩家落子（无论黑白，与 handleAIMove 一样异步执行）
  * @param game 游戏指针
- * @return 落子是否成功
+ * @return 是否已提交搜索或直接落子
  */
 bool makeAIMoveForCurrentPlayer(Game* game);
 
+/**
+ * @brief 取消等待中的AI落子
+ * @param game 游戏指针
+ */
+void cancelAIMove(Game* game);
+
+/**
+ * @brief 驱动AI引擎（每帧调用）：提交已完成的搜索结果，人机模式下轮到AI时开始搜索，
+ *        轮到玩家时让AI在后台思考
+ * @param game 游戏指针
+ */
+void updateAI(Game* game);
+
 /**
  * @brief 切换游戏模式
  * @param game 游戏指针
@@ -92,6 +108,14 @@ bool handleUndo(Game* game);
  */
 bool handleRedo(Game* game);
 
+/**
+ * @brief 处理跳转到历史记录中的某一手
+ * @param game 游戏指针
+ * @param moveNumber 目标手数（超出范围时跳到开局或最后一手）
+ * @return 是否成功
+ */
+bool handleGotoMove(Game* game, int moveNumber);
+
 /**
  * @brief 更新游戏状态
  * @param game 游戏指针
@@ -114,9 +138,9 @@ void endGameManually(Game* game);
 /**
  * @brief 获取违规行为提示信息
  * @param game 游戏指针
- * @param pos 位置
+ * @param vertex 格点
  * @return 提示信息（如果没有违规则返回NULL）
  */
-const char* getViolationHint(Game* game, Position pos);
+const char* getViolationHint(Game* game, int vertex);
 
 #endif // GAME_H
\ No newline at end of file
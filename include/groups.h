@@ -0,0 +1,80 @@
+/**
+ * @file groups.h
+ * @brief 增量维护的棋子组表（Board 的默认后端和 PlayoutBoard 共用）
+ *
+ * 每个棋子记录所属组的代表点，组内棋子串成循环链表，代表点上记录组的棋子数和气数。
+ * 落子时只检查四个相邻点，合并或提取涉及的棋子组。棋子组表不保存棋盘本身，
+ * 各函数直接操作调用者的棋盘数组。
+ */
+
+// 默认后端下 board.h 会反过来包含本文件，因此先于头文件保护包含 board.h
+#include "board.h"
+
+#ifndef GROUPS_H
+#define GROUPS_H
+
+// 棋子组表
+typedef struct {
+    int16_t groupId[BOARD_VERTICES];      // 每个点所属棋子组的代表点（空位为 NO_VERTEX）
+    int16_t nextStone[BOARD_VERTICES];    // 组内棋子的循环链表
+    int16_t groupStones[BOARD_VERTICES];  // 棋子组的棋子数（仅代表点有效）
+    int16_t groupLibs[BOARD_VERTICES];    // 棋子组的气数（仅代表点有效）
+} GroupTable;
+
+/**
+ * @brief 根据棋盘重建整个棋子组表
+ * @param groups 棋子组表
+ * @param board 棋盘数组（含 OFFBOARD 边界）
+ */
+void buildGroupTable(GroupTable* groups, const uint8_t* board);
+
+/**
+ * @brief 从一个尚未归组的棋子出发，把连通的同色棋子建成新的棋子组
+ * @param groups 棋子组表（这些棋子的 groupId 应为 NO_VERTEX）
+ * @param board 棋盘数组
+ * @param seed 起始棋子，成为新组的代表点
+ */
+void buildGroup(GroupTable* groups, const uint8_t* board, int seed);
+
+/**
+ * @brief 遍历组内全部棋子重新计算棋子组的气数
+ * @param groups 棋子组表
+ * @param board 棋盘数组
+ * @param head 棋子组代表点
+ * @return 气数
+ */
+int countGroupLiberties(const GroupTable* groups, const uint8_t* board, int head);
+
+/**
+ * @brief 检查指定颜色在空位落子是否是自杀（不检查打劫）
+ * @param groups 棋子组表
+ * @param board 棋盘数组
+ * @param vertex 落子格点（应为空位）
+ * @param color 棋子颜色
+ * @return 是否是自杀
+ */
+bool isGroupSuicide(const GroupTable* groups, const uint8_t* board, int vertex, Stone color);
+
+/**
+ * @brief 放置棋子，合并相邻的己方棋子组并更新相邻棋子组的气数
+ *
+ * 无气的对方棋子组不会被移除：调用者处理完这些棋子后再调用 removeGroupStones。
+ * @param groups 棋子组表
+ * @param board 棋盘数组
+ * @param vertex 落子格点（调用前已确认合法）
+ * @param color 棋子颜色
+ * @param dead 无气的对方棋子组代表点（输出，最多 4 个）
+ * @return 无气的对方棋子组数量
+ */
+int placeGroupStone(GroupTable* groups, uint8_t* board, int vertex, Stone color, int dead[4]);
+
+/**
+ * @brief 移除整个棋子组，并为相邻的棋子组增加气
+ * @param groups 棋子组表
+ * @param board 棋盘数组
+ * @param head 棋子组代表点
+ * @return 移除的棋子数量
+ */
+int removeGroupStones(GroupTable* groups, uint8_t* board, int head);
+
+#endif // GROUPS_H
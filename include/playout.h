@@ -0,0 +1,170 @@
+/**
+ * @file playout.h
+ * @brief 搜索与模拟专用的轻量棋盘
+ *
+ * 只保留落子、提子和打劫所需的状态：没有历史记录、没有气数总和，也不分配堆内存，
+ * 整个结构可以直接按值复制。搜索开始时从 Board 拍一次快照，之后的模拟都在副本上进行。
+ */
+
+#ifndef PLAYOUT_H
+#define PLAYOUT_H
+
+#include "board.h"
+#include "groups.h"
+#include "rng.h"
+
+// 3×3邻域编码中八个相邻格点的偏移（依次为上、右、下、左、右上、右下、左下、左上）
+extern const int NEIGHBOURHOOD_OFFSETS[8];
+
+// 轻量棋盘
+typedef struct {
+    uint8_t board[BOARD_VERTICES];        // 棋盘状态（含 OFFBOARD 边框）
+    GroupTable groups;                    // 棋子组表（落子和提子时增量维护）
+    uint16_t neighbourhood[BOARD_VERTICES]; // 3×3邻域编码（落子和提子时增量更新，仅棋盘内格点有效）
+    Stone currentPlayer;                  // 轮到谁下
+    int lastMove;                         // 上一步落子格点
+    int previousMove;                     // 再上一步落子格点
+    int koPosition;                       // 打劫禁着点（NO_VERTEX 表示无）
+    int blackCaptures;                    // 黑方提子数
+    int whiteCaptures;                    // 白方提子数
+    int blackStones;                      // 棋盘上的黑子数
+    int whiteStones;                      // 棋盘上的白子数
+    uint64_t hash;                        // 棋子的 Zobrist 哈希（与 Board 的哈希一致）
+    int16_t emptyPoints[BOARD_SIZE * BOARD_SIZE]; // 棋盘内全部空点（无序，紧凑存放）
+    int16_t emptyIndex[BOARD_VERTICES];   // 空点在 emptyPoints 中的下标（仅空点有效）
+    int emptyCount;                       // 空点数量
+} PlayoutBoard;
+
+/**
+ * @brief 从完整棋盘拍摄快照
+ * @param pb 轻量棋盘指针
+ * @param board 完整棋盘指针
+ */
+void initPlayoutBoard(PlayoutBoard* pb, const Board* board);
+
+/**
+ * @brief 计算搜索用的局面键：在棋子哈希上再区分行棋方和打劫禁着点
+ * @param hash 棋子的 Zobrist 哈希
+ * @param player 轮到谁下
+ * @param koPosition 打劫禁着点（NO_VERTEX 表示无）
+ * @return 局面键
+ */
+uint64_t positionKey(uint64_t hash, Stone player, int koPosition);
+
+/**
+ * @brief 获取轻量棋盘当前局面的局面键
+ * @param pb 轻量棋盘指针
+ * @return 局面键
+ */
+uint64_t playoutKey(const PlayoutBoard* pb);
+
+/**
+ * @brief 不落子而计算当前玩家在指定格点落子后的局面键（调用者需保证合法）
+ * @param pb 轻量棋盘指针
+ * @param vertex 格点编号
+ * @return 落子后的局面键
+ */
+uint64_t playoutKeyAfter(const PlayoutBoard* pb, int vertex);
+
+/**
+ * @brief 检查当前玩家在指定格点落子是否合法（只检查简单劫，不检查全局同形）
+ * @param pb 轻量棋盘指针
+ * @param vertex 格点编号
+ * @return 是否合法
+ */
+bool playoutIsLegal(const PlayoutBoard* pb, int vertex);
+
+/**
+ * @brief 获取格点周围3×3邻域的编码（八个相邻格点各占两位，依次为上、右、下、左、右上、右下、左下、左上）
+ *
+ * 编码随落子和提子增量维护，读取只需一次访存。
+ * @param pb 轻量棋盘指针
+ * @param vertex 棋盘内的格点编号
+ * @return 邻域编码（0 ~ 65535）
+ */
+int playoutNeighbourhood(const PlayoutBoard* pb, int vertex);
+
+/**
+ * @brief 检查空点是否是指定一方的单点真眼（查预先计算的3×3模式表）
+ *
+ * 四个相邻点都是己方棋子或棋盘外；对角上的对方棋子在棋盘中间最多一个，在边上和角上不能有。
+ * @param pb 轻量棋盘指针
+ * @param vertex 空点格点编号
+ * @param color 一方的颜色
+ * @return 是否是眼
+ */
+bool playoutIsEye(const PlayoutBoard* pb, int vertex, Stone color);
+
+/**
+ * @brief 检查指定一方在空点落子后是否是只剩一口气的孤子形状（查3×3模式表）
+ *
+ * 只看邻域：相邻没有己方棋子，空点最多一个。落子若能提掉对方棋子则不算自紧气，需要调用者结合气数判断。
+ * @param pb 轻量棋盘指针
+ * @param vertex 空点格点编号
+ * @param color 落子方的颜色
+ * @return 是否是自紧气的形状
+ */
+bool playoutIsSelfAtariShape(const PlayoutBoard* pb, int vertex, Stone color);
+
+/**
+ * @brief 检查指定一方在空点落子后所在的棋子组是否最多只剩一口气
+ *
+ * 能提掉对方棋子的落子不算；与己方棋子组相连时沿组内棋子找气，找到两口气即返回。
+ * @param pb 轻量棋盘指针
+ * @param vertex 空点格点编号
+ * @param color 落子方的颜色
+ * @return 是否自紧气
+ */
+bool playoutIsSelfAtari(const PlayoutBoard* pb, int vertex, Stone color);
+
+/**
+ * @brief 找出棋子组的一口气（用于只剩一口气的棋子组）
+ * @param pb 轻量棋盘指针
+ * @param vertex 棋子组中任一棋子的格点编号
+ * @return 气的格点编号（没有气时为 NO_VERTEX）
+ */
+int playoutGroupLiberty(const PlayoutBoard* pb, int vertex);
+
+/**
+ * @brief 检查空点周围是否匹配 MoGo 的3×3模式（挡、扳、断、爬等，双方通用）
+ * @param pb 轻量棋盘指针
+ * @param vertex 空点格点编号
+ * @return 是否匹配
+ */
+bool playoutMatchesPattern(const PlayoutBoard* pb, int vertex);
+
+/**
+ * @brief 为当前玩家均匀随机地选择一个合法且不填自己眼的落子
+ *
+ * 在空点表中随机抽取，不合适的点交换到待选范围之外后继续抽取，每个空点最多检查一次。
+ * @param pb 轻量棋盘指针（空点表的顺序会被打乱）
+ * @param rng 随机数生成器
+ * @return 落子格点（没有可下的点时为 NO_VERTEX，应当停一手）
+ */
+int playoutRandomMove(PlayoutBoard* pb, Rng* rng);
+
+/**
+ * @brief 按数子法（Tromp-Taylor）计算黑方领先的子数，不含贴目
+ *
+ * 棋子各归其主；一块空地只与一方棋子相邻时归该方。终局时空点几乎都是单点眼，
+ * 只看四个相邻点即可判断，只有与其他空点相连的空地才需要泛洪。
+ * @param pb 轻量棋盘指针
+ * @return 黑方子数减白方子数
+ */
+int playoutScore(const PlayoutBoard* pb);
+
+/**
+ * @brief 当前玩家停一手：清除劫，交换行棋方
+ * @param pb 轻量棋盘指针
+ */
+void playoutPass(PlayoutBoard* pb);
+
+/**
+ * @brief 当前玩家在指定格点落子并提子，然后交换行棋方（调用者需保证合法）
+ * @param pb 轻量棋盘指针
+ * @param vertex 格点编号
+ * @return 提子数量
+ */
+int playoutPlay(PlayoutBoard* pb, int vertex);
+
+#endif // PLAYOUT_H
\ No newline at end of file
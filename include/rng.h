@@ -0,0 +1,63 @@
+/**
+ * @file rng.h
+ * @brief 搜索专用的快速随机数生成器（xoshiro256**，用 splitmix64 播种）
+ *
+ * 每个搜索线程持有自己的生成器，不共享任何全局状态；相同的种子产生相同的序列。
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// 随机数生成器状态
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+/**
+ * @brief 用种子和流编号初始化生成器，同一种子的不同流互不相关
+ * @param rng 生成器指针
+ * @param seed 种子
+ * @param stream 流编号（例如线程序号）
+ */
+void seedRng(Rng* rng, uint64_t seed, uint64_t stream);
+
+/**
+ * @brief 生成一个随机种子（基于高精度计时器，每次调用都不同）
+ * @return 种子
+ */
+uint64_t freshRngSeed(void);
+
+static inline uint64_t rngRotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief 生成下一个64位随机数
+ */
+static inline uint64_t rngNext(Rng* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = rngRotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rngRotl(s[3], 45);
+    
+    return result;
+}
+
+/**
+ * @brief 生成 [0, bound) 范围内的随机整数（乘法取高位，无分支无除法）
+ * @param rng 生成器指针
+ * @param bound 上界（必须为正）
+ */
+static inline int rngBelow(Rng* rng, int bound) {
+    return (int)(((rngNext(rng) >> 32) * (uint64_t)(uint32_t)bound) >> 32);
+}
+
+#endif // RNG_H
\ No newline at end of file
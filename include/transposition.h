@@ -0,0 +1,65 @@
+/**
+ * @file transposition.h
+ * @brief 置换表：从局面键找到搜索树中代表该局面的节点
+ *
+ * 不同落子顺序到达的相同局面共用一个节点，搜索树因此成为有向无环图。
+ * 表中只保存节点指针，用CAS无锁更新；查找时用节点自身保存的局面键确认命中，
+ * 因此被替换掉的条目不会让其他线程拿到错误的节点。
+ */
+
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 每个桶的槽数（查找和替换都在同一个桶内进行）
+#define TRANSPOSITION_BUCKET 4
+
+struct MCTSNode;
+
+// 置换表
+typedef struct {
+    void** slots;                 // 节点指针（NULL 表示空槽）
+    int slotCount;                // 槽数（2的幂，0 表示不使用置换表）
+} TranspositionTable;
+
+/**
+ * @brief 按内存上限分配置换表
+ * @param table 置换表指针
+ * @param maxBytes 内存上限（字节，不足一个桶时不分配）
+ * @return 是否成功（内存上限为 0 也视为成功）
+ */
+bool initTranspositionTable(TranspositionTable* table, size_t maxBytes);
+
+/**
+ * @brief 释放置换表
+ * @param table 置换表指针
+ */
+void freeTranspositionTable(TranspositionTable* table);
+
+/**
+ * @brief 清空置换表（节点池重置或节点搬移后调用）
+ * @param table 置换表指针
+ */
+void clearTranspositionTable(TranspositionTable* table);
+
+/**
+ * @brief 查找局面键对应的节点（可被多个线程同时调用）
+ * @param table 置换表指针
+ * @param key 局面键
+ * @return 节点指针（未找到时为 NULL）
+ */
+struct MCTSNode* lookupTransposition(TranspositionTable* table, uint64_t key);
+
+/**
+ * @brief 登记节点（可被多个线程同时调用）
+ *
+ * 桶已满时替换访问次数最少的节点；其他线程同时改动该桶时放弃登记。
+ * @param table 置换表指针
+ * @param node 节点（局面键必须已经设置）
+ */
+void storeTransposition(TranspositionTable* table, struct MCTSNode* node);
+
+#endif // TRANSPOSITION_H
\ No newline at end of file
@@ -78,16 +78,8 @@ int main(int argc, char* argv[]) {
         // 更新游戏状态
         updateGame(&game);
         
-        // 如果是AI模式且轮到AI下棋且AI未在思考中
-        if (game.mode == MODE_PVE && 
-            game.state == STATE_PLAYING && 
-            game.board.currentPlayer == WHITE && 
-            !game.aiThinking) {
-            
-            game.aiThinking = true;
-            handleAIMove(&game);
-            game.aiThinking = false;
-        }
+        // 驱动AI引擎：落下已完成的搜索结果，轮到AI时开始搜索，轮到玩家时后台思考
+        updateAI(&game);
         
         // 渲染游戏
         renderGame(&gui, &game);
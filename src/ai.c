@@ -5,15 +5,17 @@
 
 #include "../include/ai.h"
 #include "../include/utils.h"
-#include "../include/game.h"
 #include <math.h>
 #include <string.h>
-#include <time.h>
 #include <SDL2/SDL.h>
 
-// 方向数组，用于检查相邻位置
-static const int DX[4] = {-1, 0, 1, 0}; // Used in expansion strategies
-static const int DY[4] = {0, -1, 0, 1}; // Used in expansion strategies
+#if defined(__AVX__)
+#define MCTS_SIMD_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#define MCTS_SIMD_SSE2
+#include <emmintrin.h>
+#endif
 
 // 优化的AI配置参数
 #define DEFAULT_SIMULATION_COUNT 200  // 增加模拟次数
@@ -21,100 +23,593 @@ static const int DY[4] = {0, -1, 0, 1}; // Used in expansion strategies
 #define DEFAULT_MAX_DEPTH 88         // 减少最大搜索深度
 #define MCTS_TIME_LIMIT 2851         // 时间限制
 #define MCTS_RANGE_SMALL 2          // 小范围搜索3×3
+#define MCTS_ARENA_NODES (1 << 15)   // 节点池容量
+#define MCTS_CHILDREN_PER_NODE 16    // 每个节点平均预留的候选落子数
+#define MCTS_MAX_THREADS 64          // 搜索线程数上限
+#define MCTS_HELPER_ARENA_MIN 256    // 根并行时辅助线程节点池的最小容量
+#define MCTS_TRANSPOSITION_MB 16     // 置换表内存上限（MB）
+#define DEFAULT_RAVE_EQUIVALENCE 1000 // RAVE 等价访问次数
+#define DEFAULT_WIDENING_BASE 4      // 渐进式扩展初始子节点数
+#define MCTS_WIDEN_START 10          // 父节点访问次数达到它时放开下一个子节点
+#define MCTS_WIDEN_FACTOR 1.5        // 之后每放开一个，所需访问次数乘以它
+#define DEFAULT_PRIOR_WEIGHT 1.0     // 先验概率权重
 
 void initAIConfig(AIConfig* config) {
     config->simulationCount = DEFAULT_SIMULATION_COUNT;
     config->explorationParameter = DEFAULT_EXPLORATION_PARAM;
     config->maxDepth = DEFAULT_MAX_DEPTH;
+    config->timeLimit = MCTS_TIME_LIMIT;
+    
+    // 默认每个处理器核心一个搜索线程
+    config->threadCount = SDL_GetCPUCount();
+    if (config->threadCount < 1) config->threadCount = 1;
+    if (config->threadCount > MCTS_MAX_THREADS) config->threadCount = MCTS_MAX_THREADS;
+    config->parallelMode = PARALLEL_TREE;
+    config->seed = 0;
+    config->transpositionMB = MCTS_TRANSPOSITION_MB;
+    config->raveEquivalence = DEFAULT_RAVE_EQUIVALENCE;
+    config->komi = KOMI;
+    config->playoutPolicy = PLAYOUT_HEAVY;
+    config->lastGoodReply = true;
+    config->wideningBase = DEFAULT_WIDENING_BASE;
+    config->priorWeight = DEFAULT_PRIOR_WEIGHT;
+}
+
+/**
+ * @brief 取本次搜索使用的随机数种子
+ * @param config AI配置
+ * @return 配置的固定种子，未配置时为新取的种子
+ */
+static uint64_t searchSeed(AIConfig* config) {
+    return config->seed ? config->seed : freshRngSeed();
+}
+
+/**
+ * @brief 候选落子表每个数组的长度（补齐到 MCTS_CHILD_LANES 的倍数）
+ */
+static int childStride(int count) {
+    return (count + MCTS_CHILD_LANES - 1) / MCTS_CHILD_LANES * MCTS_CHILD_LANES;
+}
+
+/**
+ * @brief 计算容纳指定数量候选落子的候选落子表大小（表头加上补齐后的各数组）
+ * @param count 候选落子数量
+ * @return 字节数（8的倍数，下一张表的指针仍然对齐）
+ */
+static int childBlockSize(int count) {
+    int perChild = sizeof(int) + sizeof(float) + 4 * sizeof(int) + sizeof(MCTSNode*);
+    return (int)sizeof(MCTSChildren) + childStride(count) * perChild;
+}
+
+bool initNodeArena(NodeArena* arena, int capacity) {
+    // 按每个节点一张平均大小的候选落子表预留
+    int childCapacity = capacity * childBlockSize(MCTS_CHILDREN_PER_NODE);
+    arena->nodes = (MCTSNode*)malloc(sizeof(MCTSNode) * capacity);
+    arena->childData = (unsigned char*)malloc(childCapacity);
+    arena->capacity = arena->nodes ? capacity : 0;
+    arena->childCapacity = arena->childData ? childCapacity : 0;
+    SDL_AtomicSet(&arena->used, 0);
+    SDL_AtomicSet(&arena->childrenUsed, 0);
+    arena->table = NULL;
+    
+    return arena->nodes != NULL && arena->childData != NULL;
+}
+
+void freeNodeArena(NodeArena* arena) {
+    free(arena->nodes);
+    free(arena->childData);
+    arena->nodes = NULL;
+    arena->childData = NULL;
+    arena->capacity = 0;
+    arena->childCapacity = 0;
+    SDL_AtomicSet(&arena->used, 0);
+    SDL_AtomicSet(&arena->childrenUsed, 0);
+}
+
+void resetNodeArena(NodeArena* arena) {
+    SDL_AtomicSet(&arena->used, 0);
+    SDL_AtomicSet(&arena->childrenUsed, 0);
+}
+
+bool nodeArenaFull(NodeArena* arena) {
+    // 一次迭代最多创建两个节点，一次扩展最多为每个格点记录一个候选落子
+    return SDL_AtomicGet(&arena->used) + 2 > arena->capacity ||
+           SDL_AtomicGet(&arena->childrenUsed) + childBlockSize(BOARD_SIZE * BOARD_SIZE) > arena->childCapacity;
+}
+
+/**
+ * @brief 从节点池中分配一块连续的节点（可被多个线程同时调用）
+ * @param arena 节点池
+ * @param count 节点数量
+ * @return 第一个节点（空间不足时为 NULL）
+ */
+static MCTSNode* allocNodes(NodeArena* arena, int count) {
+    int used;
+    
+    // 用CAS移动分配位置，空间不足时不改动
+    do {
+        used = SDL_AtomicGet(&arena->used);
+        if (used + count > arena->capacity) return NULL;
+    } while (!SDL_AtomicCAS(&arena->used, used, used + count));
+    
+    return arena->nodes + used;
+}
+
+/**
+ * @brief 候选落子的统计加上 n（relaxed 原子操作，只要求计数本身不丢失）
+ */
+static inline void addChildStat(int* stat, int n) {
+    __atomic_fetch_add(stat, n, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 读取候选落子的统计（relaxed 原子读取，不与其他统计保持一致）
+ */
+static inline int getChildStat(const int* stat) {
+    return __atomic_load_n(stat, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 从节点池中分配一张全部清零的候选落子表（可被多个线程同时调用）
+ * @param arena 节点池
+ * @param count 候选落子数量
+ * @return 候选落子表（空间不足时为 NULL）
+ */
+static MCTSChildren* allocChildren(NodeArena* arena, int count) {
+    int size = childBlockSize(count);
+    int used;
+    
+    do {
+        used = SDL_AtomicGet(&arena->childrenUsed);
+        if (used + size > arena->childCapacity) return NULL;
+    } while (!SDL_AtomicCAS(&arena->childrenUsed, used, used + size));
+    
+    // 各数组依次紧跟在表头之后，布局只取决于候选落子数量
+    MCTSChildren* children = (MCTSChildren*)(arena->childData + used);
+    memset(children + 1, 0, size - sizeof(MCTSChildren));
+    
+    int stride = childStride(count);
+    children->stride = stride;
+    children->moves = (int*)(children + 1);
+    children->priors = (float*)(children->moves + stride);
+    children->visits = (int*)(children->priors + stride);
+    children->wins = children->visits + stride;
+    children->amafVisits = children->wins + stride;
+    children->amafWins = children->amafVisits + stride;
+    children->nodes = (MCTSNode**)(children->amafWins + stride);
+    
+    return children;
+}
+
+/**
+ * @brief 初始化节点
+ * @param node 节点
+ * @param parent 父节点
+ * @param move 落子格点
+ * @param player 玩家
+ * @param key 局面键
+ */
+static void initNode(MCTSNode* node, MCTSNode* parent, int move, Stone player, uint64_t key) {
+    node->move = move;
+    node->player = player;
+    node->key = key;
+    SDL_AtomicSet(&node->visits, 0);
+    SDL_AtomicSet(&node->state, NODE_LEAF);
+    node->childrenCount = 0;
+    node->children = NULL;
+    node->parent = parent;
+}
+
+/**
+ * @brief 为候选落子创建子节点并发布（可被多个线程同时调用）
+ *
+ * 局面已经在树中出现过时直接指向已有节点。多个线程同时创建时只有一个节点通过CAS发布，
+ * 其余线程改用它，各自分配的节点弃置在池中。
+ * @param arena 节点池
+ * @param parent 父节点
+ * @param index 候选落子的下标
+ * @param key 子节点局面的哈希
+ * @return 子节点（节点池已满时为 NULL）
+ */
+static MCTSNode* createChild(NodeArena* arena, MCTSNode* parent, int index, uint64_t key) {
+    MCTSNode** slot = &parent->children->nodes[index];
+    MCTSNode* existing = arena->table ? lookupTransposition(arena->table, key) : NULL;
+    MCTSNode* node = existing;
+    
+    if (!node) {
+        node = allocNodes(arena, 1);
+        if (!node) return NULL;
+        
+        Stone nextPlayer = (parent->player == BLACK) ? WHITE : BLACK;
+        initNode(node, parent, parent->children->moves[index], nextPlayer, key);
+    }
+    
+    if (!SDL_AtomicCASPtr((void**)slot, NULL, node)) {
+        return (MCTSNode*)SDL_AtomicGetPtr((void**)slot);
+    }
+    
+    // 发布成功后才登记为该局面的节点
+    if (arena->table && !existing) {
+        storeTransposition(arena->table, node);
+    }
+    
+    return node;
 }
 
-MCTSNode* createRootNode(Board* board) {
-    MCTSNode* root = (MCTSNode*)malloc(sizeof(MCTSNode));
+/**
+ * @brief 取得候选落子对应的子节点，还没有时创建
+ * @param arena 节点池
+ * @param parent 父节点
+ * @param index 候选落子的下标
+ * @param pb 父节点的局面
+ * @return 子节点（节点池已满时为 NULL）
+ */
+static MCTSNode* materializeChild(NodeArena* arena, MCTSNode* parent, int index, const PlayoutBoard* pb) {
+    MCTSNode* node = (MCTSNode*)SDL_AtomicGetPtr((void**)&parent->children->nodes[index]);
+    if (node) return node;
+    
+    return createChild(arena, parent, index, playoutKeyAfter(pb, parent->children->moves[index]));
+}
+
+MCTSNode* createRootNode(NodeArena* arena, Board* board) {
+    MCTSNode* root = allocNodes(arena, 1);
     if (!root) return NULL;
     
     // 初始化根节点
-    root->move.x = -1;
-    root->move.y = -1;
-    root->player = board->currentPlayer;
-    root->visits = 0;
-    root->wins = 0;
-    root->childrenCount = 0;
-    root->children = NULL;
-    root->parent = NULL;
+    uint64_t key = positionKey(board->hash, board->currentPlayer, board->koActive ? board->koPosition : NO_VERTEX);
+    initNode(root, NULL, NO_VERTEX, board->currentPlayer, key);
+    
+    if (arena->table) {
+        storeTransposition(arena->table, root);
+    }
     
     return root;
 }
 
-void freeMCTSTree(MCTSNode* node) {
-    if (!node) return;
+bool initSearchTree(SearchTree* tree, AIConfig* config) {
+    tree->activeArena = 0;
+    tree->root = NULL;
+    tree->rootMoveNumber = -1;
+    tree->rootHash = 0;
     
-    // 递归释放所有子节点
-    for (int i = 0; i < node->childrenCount; i++) {
-        freeMCTSTree(node->children[i]);
+    bool ok = initNodeArena(&tree->arenas[0], MCTS_ARENA_NODES);
+    ok = initNodeArena(&tree->arenas[1], MCTS_ARENA_NODES) && ok;
+    ok = initTranspositionTable(&tree->table, (size_t)config->transpositionMB << 20) && ok;
+    
+    // 两个节点池共用一张置换表，任何时候只有当前树的节点登记在其中
+    tree->arenas[0].table = &tree->table;
+    tree->arenas[1].table = &tree->table;
+    
+    return ok;
+}
+
+void freeSearchTree(SearchTree* tree) {
+    freeNodeArena(&tree->arenas[0]);
+    freeNodeArena(&tree->arenas[1]);
+    freeTranspositionTable(&tree->table);
+    tree->root = NULL;
+}
+
+void clearSearchTree(SearchTree* tree) {
+    resetNodeArena(&tree->arenas[0]);
+    resetNodeArena(&tree->arenas[1]);
+    clearTranspositionTable(&tree->table);
+    tree->root = NULL;
+    tree->rootMoveNumber = -1;
+}
+
+/**
+ * @brief 把子树复制到空闲的节点池作为新根，然后丢弃旧池中的其余节点
+ * @param tree 搜索树
+ * @param node 要提升的节点
+ */
+static void promoteSubtree(SearchTree* tree, MCTSNode* node) {
+    NodeArena* src = &tree->arenas[tree->activeArena];
+    NodeArena* dst = &tree->arenas[1 - tree->activeArena];
+    
+    resetNodeArena(dst);
+    MCTSNode* root = allocNodes(dst, 1);
+    *root = *node;
+    root->parent = NULL;
+    
+    // 旧节点复制完后不再需要，用它的 parent 记下新位置；置换节点从多条边到达时只复制一次
+    node->parent = root;
+    
+    // 按广度优先顺序复制：新池中的节点依次复制自己的候选落子表和已创建的子节点，
+    // 子树不会比旧池中的内容更多，因此分配总能成功
+    for (int i = 0; i < SDL_AtomicGet(&dst->used); i++) {
+        MCTSNode* copy = &dst->nodes[i];
+        if (copy->childrenCount == 0) continue;
+        
+        MCTSChildren* children = allocChildren(dst, copy->childrenCount);
+        memcpy(children + 1, copy->children + 1, childBlockSize(copy->childrenCount) - sizeof(MCTSChildren));
+        for (int j = 0; j < copy->childrenCount; j++) {
+            MCTSNode* old = children->nodes[j];
+            if (!old) continue;
+            
+            MCTSNode* moved = old->parent;
+            if (!(moved >= dst->nodes && moved < dst->nodes + SDL_AtomicGet(&dst->used))) {
+                moved = allocNodes(dst, 1);
+                *moved = *old;
+                moved->move = children->moves[j];
+                moved->parent = copy;
+                old->parent = moved;
+            }
+            children->nodes[j] = moved;
+        }
+        copy->children = children;
+    }
+    
+    // 用新位置重建置换表
+    int used = SDL_AtomicGet(&dst->used);
+    clearTranspositionTable(&tree->table);
+    for (int i = 0; i < used; i++) {
+        storeTransposition(&tree->table, &dst->nodes[i]);
+    }
+    
+    resetNodeArena(src);
+    tree->activeArena = 1 - tree->activeArena;
+    tree->root = root;
+}
+
+MCTSNode* advanceSearchTree(SearchTree* tree, Board* board) {
+    MCTSNode* node = NULL;
+    
+    // 在历史记录中找到旧根节点对应的局面，确认当前局面是从它走下来的
+    if (tree->root && board->current) {
+        BoardHistory* history = board->current;
+        while (history && history->moveNumber > tree->rootMoveNumber) {
+            history = history->prev;
+        }
+        
+        if (history && history->moveNumber == tree->rootMoveNumber && history->hash == tree->rootHash) {
+            // 沿之后的每一步落子向下找对应的子节点
+            node = tree->root;
+            while (node && history != board->current) {
+                history = history->next;
+                
+                // 没有创建过子节点的落子没有可复用的统计
+                MCTSNode* match = NULL;
+                for (int i = 0; i < node->childrenCount; i++) {
+                    if (node->children->moves[i] == history->move) {
+                        match = node->children->nodes[i];
+                        break;
+                    }
+                }
+                node = match;
+            }
+        }
     }
     
-    // 释放子节点数组
-    if (node->children) {
-        free(node->children);
+    if (node) {
+        if (node != tree->root) {
+            promoteSubtree(tree, node);
+        }
+    } else {
+        clearSearchTree(tree);
+        tree->root = createRootNode(&tree->arenas[tree->activeArena], board);
     }
     
-    // 释放节点本身
-    free(node);
+    tree->rootMoveNumber = board->current ? board->current->moveNumber : -1;
+    tree->rootHash = board->hash;
+    
+    return tree->root;
 }
 
 /**
- * @brief 创建子节点
- * @param parent 父节点
- * @param move 落子位置
- * @param player 玩家
- * @return 创建的子节点
+ * @brief 计算一组候选落子的UCT值（启用 RAVE 时胜率项混合 AMAF 胜率）
+ *
+ * 与父节点有关的对数和平方根只算一次，之后每 MCTS_CHILD_LANES 个候选落子一组用 SIMD 指令计算
+ * （编译器支持 AVX 时一次8个，SSE2 时一次4个，否则逐个计算），没有访问过的落子得到无穷大。
+ * 其他线程可能同时更新统计，先用 relaxed 原子读取把参与选择的统计逐个复制到局部缓冲区，
+ * 向量指令只读取缓冲区；各计数之间不保证一致，最多差几次正在进行的更新，只影响这一次选择。
+ * @param children 候选落子表
+ * @param count 参与选择的候选落子数量（按组补齐计算，不超过 children->stride）
+ * @param parentVisits 父节点访问次数（至少为1）
+ * @param config AI配置
+ * @param scores UCT值（输出，长度按组补齐）
+ */
+static void scoreChildren(const MCTSChildren* children, int count, int parentVisits, const AIConfig* config, float* scores) {
+    float logParent = logf((float)parentVisits);
+    float sqrtParent = sqrtf((float)parentVisits);
+    float parentScale = 1.0f / (parentVisits + 1);
+    float exploration = (float)config->explorationParameter;
+    float priorWeight = (float)config->priorWeight;
+    float k = (float)config->raveEquivalence;
+    
+    // 统计快照（补齐部分也复制，补齐的计数始终为0）
+    int padded = childStride(count);
+    int visits[BOARD_SIZE * BOARD_SIZE + MCTS_CHILD_LANES];
+    int wins[BOARD_SIZE * BOARD_SIZE + MCTS_CHILD_LANES];
+    int amafVisits[BOARD_SIZE * BOARD_SIZE + MCTS_CHILD_LANES];
+    int amafWins[BOARD_SIZE * BOARD_SIZE + MCTS_CHILD_LANES];
+    for (int j = 0; j < padded; j++) {
+        visits[j] = getChildStat(&children->visits[j]);
+        wins[j] = getChildStat(&children->wins[j]);
+        amafVisits[j] = getChildStat(&children->amafVisits[j]);
+        amafWins[j] = getChildStat(&children->amafWins[j]);
+    }
+    int i = 0;
+    
+#if defined(MCTS_SIMD_AVX)
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 two = _mm256_set1_ps(2.0f);
+    __m256 three = _mm256_set1_ps(3.0f);
+    __m256 infinity = _mm256_set1_ps(INFINITY);
+    __m256 vk = _mm256_set1_ps(k);
+    __m256 raveEnabled = (k > 0) ? _mm256_castsi256_ps(_mm256_set1_epi32(-1)) : zero;
+    for (; i < count; i += 8) {
+        __m256 v = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(visits + i)));
+        __m256 w = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(wins + i)));
+        __m256 av = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(amafVisits + i)));
+        __m256 aw = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(amafWins + i)));
+        __m256 p = _mm256_loadu_ps(children->priors + i);
+        
+        // 胜率：访问次数少时主要参考 AMAF 胜率，随访问次数增加逐渐过渡到这条边自身的胜率
+        __m256 n = _mm256_max_ps(v, one);
+        __m256 value = _mm256_div_ps(w, n);
+        __m256 useRave = _mm256_and_ps(raveEnabled, _mm256_cmp_ps(av, zero, _CMP_GT_OQ));
+        __m256 beta = _mm256_sqrt_ps(_mm256_div_ps(vk, _mm256_add_ps(_mm256_mul_ps(three, v), vk)));
+        __m256 amafValue = _mm256_div_ps(aw, _mm256_max_ps(av, one));
+        __m256 mixed = _mm256_add_ps(value, _mm256_mul_ps(beta, _mm256_sub_ps(amafValue, value)));
+        value = _mm256_blendv_ps(value, mixed, useRave);
+        
+        // 探索项随访问次数逐渐减小权重（边的访问次数可能超过父节点，系数不小于0），先验概率偏置随访问次数增加而减小
+        __m256 factor = _mm256_max_ps(_mm256_sub_ps(two, _mm256_mul_ps(n, _mm256_set1_ps(parentScale))), zero);
+        __m256 explore = _mm256_mul_ps(_mm256_set1_ps(exploration),
+                                       _mm256_sqrt_ps(_mm256_div_ps(_mm256_mul_ps(factor, _mm256_set1_ps(logParent)), n)));
+        __m256 bias = _mm256_div_ps(_mm256_mul_ps(_mm256_set1_ps(priorWeight * sqrtParent), p), _mm256_add_ps(v, one));
+        __m256 score = _mm256_add_ps(_mm256_add_ps(value, explore), bias);
+        
+        __m256 unvisited = _mm256_andnot_ps(useRave, _mm256_cmp_ps(v, zero, _CMP_EQ_OQ));
+        _mm256_storeu_ps(scores + i, _mm256_blendv_ps(score, infinity, unvisited));
+    }
+#elif defined(MCTS_SIMD_SSE2)
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 zero = _mm_setzero_ps();
+    __m128 two = _mm_set1_ps(2.0f);
+    __m128 three = _mm_set1_ps(3.0f);
+    __m128 infinity = _mm_set1_ps(INFINITY);
+    __m128 vk = _mm_set1_ps(k);
+    __m128 raveEnabled = (k > 0) ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+    for (; i < count; i += 4) {
+        __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(visits + i)));
+        __m128 w = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(wins + i)));
+        __m128 av = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(amafVisits + i)));
+        __m128 aw = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(amafWins + i)));
+        __m128 p = _mm_loadu_ps(children->priors + i);
+        
+        // SSE2 没有按掩码混合的指令，用与、与非、或组合
+        __m128 n = _mm_max_ps(v, one);
+        __m128 value = _mm_div_ps(w, n);
+        __m128 useRave = _mm_and_ps(raveEnabled, _mm_cmpgt_ps(av, zero));
+        __m128 beta = _mm_sqrt_ps(_mm_div_ps(vk, _mm_add_ps(_mm_mul_ps(three, v), vk)));
+        __m128 amafValue = _mm_div_ps(aw, _mm_max_ps(av, one));
+        __m128 mixed = _mm_add_ps(value, _mm_mul_ps(beta, _mm_sub_ps(amafValue, value)));
+        value = _mm_or_ps(_mm_and_ps(useRave, mixed), _mm_andnot_ps(useRave, value));
+        
+        __m128 factor = _mm_max_ps(_mm_sub_ps(two, _mm_mul_ps(n, _mm_set1_ps(parentScale))), zero);
+        __m128 explore = _mm_mul_ps(_mm_set1_ps(exploration),
+                                    _mm_sqrt_ps(_mm_div_ps(_mm_mul_ps(factor, _mm_set1_ps(logParent)), n)));
+        __m128 bias = _mm_div_ps(_mm_mul_ps(_mm_set1_ps(priorWeight * sqrtParent), p), _mm_add_ps(v, one));
+        __m128 score = _mm_add_ps(_mm_add_ps(value, explore), bias);
+        
+        __m128 unvisited = _mm_andnot_ps(useRave, _mm_cmpeq_ps(v, zero));
+        _mm_storeu_ps(scores + i, _mm_or_ps(_mm_and_ps(unvisited, infinity), _mm_andnot_ps(unvisited, score)));
+    }
+#endif
+    
+    // 没有 SIMD 指令时逐个计算，公式与上面相同
+    for (; i < count; i++) {
+        int v = visits[i];
+        int av = amafVisits[i];
+        bool useRave = k > 0 && av > 0;
+        if (v == 0 && !useRave) {
+            scores[i] = INFINITY;
+            continue;
+        }
+        
+        float n = (float)(v > 0 ? v : 1);
+        float value = wins[i] / n;
+        if (useRave) {
+            float beta = sqrtf(k / (3.0f * v + k));
+            value += beta * ((float)amafWins[i] / av - value);
+        }
+        
+        float explore = exploration * sqrtf(fmaxf(2.0f - n * parentScale, 0.0f) * logParent / n);
+        float bias = priorWeight * sqrtParent * children->priors[i] / (v + 1.0f);
+        scores[i] = value + explore + bias;
+    }
+}
+
+/**
+ * @brief 渐进式扩展：按父节点的访问次数计算参与选择的子节点数（子节点已按先验概率排列）
+ * @param node 已扩展的节点
+ * @param visits 节点的访问次数
+ * @param config AI配置
+ * @return 前多少个子节点参与选择
  */
-static MCTSNode* createChildNode(MCTSNode* parent, Position move, Stone player) {
-    MCTSNode* child = (MCTSNode*)malloc(sizeof(MCTSNode));
-    if (!child) return NULL;
+static int widenedChildCount(const MCTSNode* node, int visits, const AIConfig* config) {
+    if (config->wideningBase <= 0) return node->childrenCount;
     
-    // 初始化子节点
-    child->move = move;
-    child->player = player;
-    child->visits = 0;
-    child->wins = 0;
-    child->childrenCount = 0;
-    child->children = NULL;
-    child->parent = parent;
+    int count = config->wideningBase;
+    double threshold = MCTS_WIDEN_START;
+    while (count < node->childrenCount && visits >= threshold) {
+        count++;
+        threshold *= MCTS_WIDEN_FACTOR;
+    }
     
-    return child;
+    return (count < node->childrenCount) ? count : node->childrenCount;
 }
 
 /**
- * @brief 计算UCT值
- * @param node 节点
- * @param parentVisits 父节点访问次数
- * @param explorationParam 探索参数
- * @return UCT值
+ * @brief 两个格点之间的棋盘距离（横纵坐标差的较大者）
  */
-static double calculateUCT(MCTSNode* node, int parentVisits, double explorationParam) {
-    if (node->visits == 0) {
-        return INFINITY; // 未访问过的节点优先选择
+static int vertexDistance(int a, int b) {
+    int dx = abs(VERTEX_X(a) - VERTEX_X(b));
+    int dy = abs(VERTEX_Y(a) - VERTEX_Y(b));
+    return (dx > dy) ? dx : dy;
+}
+
+/**
+ * @brief 计算当前玩家落子的启发式评分（未归一化的先验）
+ *
+ * 吃子、逃子、叫吃和3×3模式加分，靠近最近两手加分，自紧气减分，各项只用增量维护的气数和邻域编码。
+ * @param pb 轻量棋盘
+ * @param move 合法的落子格点
+ * @return 评分（大于0）
+ */
+static double movePriorScore(const PlayoutBoard* pb, int move) {
+    Stone color = pb->currentPlayer;
+    double score = 1.0;
+    bool captures = false;
+    
+    for (int i = 0; i < 4; i++) {
+        int next = move + NEIGHBOR_OFFSETS[i];
+        Stone neighbor = (Stone)pb->board[next];
+        if (neighbor != BLACK && neighbor != WHITE) continue;
+        
+        int liberties = pb->groups.groupLibs[pb->groups.groupId[next]];
+        if (neighbor != color) {
+            if (liberties == 1) {
+                captures = true;
+                score += 8.0 + pb->groups.groupStones[pb->groups.groupId[next]];
+            } else if (liberties == 2) {
+                score += 2.0;
+            }
+        } else if (liberties == 1) {
+            score += 6.0;
+        }
+    }
+    
+    if (playoutMatchesPattern(pb, move)) score += 2.0;
+    
+    if (pb->lastMove != NO_VERTEX) {
+        int distance = vertexDistance(move, pb->lastMove);
+        if (distance <= 1) score += 3.0;
+        else if (distance == 2) score += 1.5;
+    }
+    if (pb->previousMove != NO_VERTEX && vertexDistance(move, pb->previousMove) <= 2) {
+        score += 1.0;
     }
     
-    // 优化的UCT公式，随着访问次数逐渐减小探索权重
-    double exploitation = node->wins / node->visits;
-    double visitFactor = sqrt(2.0 - (node->visits / (double)(parentVisits + 1)));
-    double exploration = explorationParam * visitFactor * sqrt(log(parentVisits) / node->visits);
+    if (!captures && playoutIsSelfAtari(pb, move, color)) score *= 0.1;
     
-    return exploitation + exploration;
+    return score;
 }
 
 /**
  * @brief 获取特定范围内的有效移动
  * @param board 棋盘
- * @param centerX 中心X坐标
- * @param centerY 中心Y坐标
+ * @param center 中心格点
  * @param range 范围
- * @param positions 输出位置数组
+ * @param moves 输出格点数组
  * @param count 计数指针
  */
-static void getValidMovesInRange(Board* board, int centerX, int centerY, int range, Position* positions, int* count) {
+static void getValidMovesInRange(Board* board, int center, int range, int* moves, int* count) {
+    int centerX = VERTEX_X(center);
+    int centerY = VERTEX_Y(center);
     *count = 0;
     
     for (int dx = -range; dx <= range; dx++) {
@@ -122,53 +617,94 @@ static void getValidMovesInRange(Board* board, int centerX, int centerY, int ran
             int x = centerX + dx;
             int y = centerY + dy;
             
-            Position pos = {x, y};
-            if (x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE && isValidMove(board, pos)) {
-                positions[*count] = pos;
+            // 范围超出一圈哨兵时仍需检查边界
+            if (x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE && isValidMove(board, VERTEX(x, y))) {
+                moves[*count] = VERTEX(x, y);
                 (*count)++;
             }
         }
     }
 }
 
-MCTSNode* selectNode(MCTSNode* node, AIConfig* config) {
-    // 如果节点没有子节点，则返回该节点
-    if (node->childrenCount == 0) {
-        return node;
-    }
+/**
+ * @brief 获取轻量棋盘上特定范围内的有效移动
+ * @param pb 轻量棋盘
+ * @param center 中心格点
+ * @param range 范围
+ * @param moves 输出格点数组
+ * @param count 计数指针
+ */
+static void getPlayoutMovesInRange(const PlayoutBoard* pb, int center, int range, int* moves, int* count) {
+    int centerX = VERTEX_X(center);
+    int centerY = VERTEX_Y(center);
+    *count = 0;
     
-    // 渐进式扩展 - 随机选择的概率随访问次数增加而减小
-    if (rand() % 100 < 5 && node->visits > 50) { // 5%的概率随机选择，且节点被访问过至少50次
-        int randomChild = rand() % node->childrenCount;
-        return selectNode(node->children[randomChild], config);
+    for (int dx = -range; dx <= range; dx++) {
+        for (int dy = -range; dy <= range; dy++) {
+            int x = centerX + dx;
+            int y = centerY + dy;
+            
+            if (x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE && playoutIsLegal(pb, VERTEX(x, y))) {
+                moves[*count] = VERTEX(x, y);
+                (*count)++;
+            }
+        }
     }
+}
+
+MCTSNode* selectNode(NodeArena* arena, MCTSNode* node, SearchContext* ctx, PlayoutBoard* pb) {
+    // 虚拟损失：经过的节点先计入访问次数，模拟结束前按失败计算，
+    // 同时下降的其他线程因此倾向于选择别的兄弟节点
+    SDL_AtomicAdd(&node->visits, 1);
+    ctx->pathLength = 0;
+    ctx->edges[ctx->pathLength] = -1;
+    ctx->path[ctx->pathLength++] = node;
     
-    // 选择UCT值最大的子节点
-    MCTSNode* bestChild = NULL;
-    double bestUCT = -INFINITY;
+    float scores[BOARD_SIZE * BOARD_SIZE + MCTS_CHILD_LANES];
     
-    for (int i = 0; i < node->childrenCount; i++) {
-        double uct = calculateUCT(node->children[i], node->visits, config->explorationParameter);
+    // 逐层向下选择，同时在轻量棋盘上走出所选的落子；路径上为扩展阶段留出空间
+    while (SDL_AtomicGet(&node->state) == NODE_EXPANDED && ctx->pathLength < MCTS_MAX_PATH - 4) {
+        MCTSChildren* children = node->children;
+        int chosen = 0;
+        int parentVisits = SDL_AtomicGet(&node->visits);
+        
+        // 渐进式扩展：只在已放开的子节点中选择
+        int childCount = widenedChildCount(node, parentVisits, ctx->config);
         
-        if (uct > bestUCT) {
-            bestUCT = uct;
-            bestChild = node->children[i];
+        // 随机选择的概率随访问次数增加而减小
+        if (rngBelow(&ctx->rng, 100) < 5 && parentVisits > 50) { // 5%的概率随机选择，且节点被访问过至少50次
+            chosen = rngBelow(&ctx->rng, childCount);
+        } else {
+            // 选择UCT值最大的子节点（从第一个子节点开始，UCT值相同时取先验概率高的）
+            scoreChildren(children, childCount, parentVisits, ctx->config, scores);
+            for (int i = 1; i < childCount; i++) {
+                if (scores[i] > scores[chosen]) chosen = i;
+            }
         }
+        
+        // 第一次选中时才创建子节点；节点池已满时从当前节点模拟
+        MCTSNode* next = materializeChild(arena, node, chosen, pb);
+        if (!next) break;
+        
+        addChildStat(&children->visits[chosen], 1);
+        SDL_AtomicAdd(&next->visits, 1);
+        ctx->edges[ctx->pathLength] = chosen;
+        ctx->path[ctx->pathLength++] = next;
+        playoutPlay(pb, children->moves[chosen]);
+        node = next;
     }
     
-    // 递归选择
-    return selectNode(bestChild, config);
+    return node;
 }
 
-int getLegalMoves(Board* board, Position* positions) {
+int getLegalMoves(Board* board, int* moves) {
     int count = 0;
     
     // 遍历整个棋盘，找出所有合法落子位置
     for (int y = 0; y < BOARD_SIZE; y++) {
         for (int x = 0; x < BOARD_SIZE; x++) {
-            Position pos = {x, y};
-            if (isValidMove(board, pos)) {
-                positions[count++] = pos;
+            if (isValidMove(board, VERTEX(x, y))) {
+                moves[count++] = VERTEX(x, y);
             }
         }
     }
@@ -176,39 +712,19 @@ int getLegalMoves(Board* board, Position* positions) {
     return count;
 }
 
-MCTSNode* expandNode(MCTSNode* node, Board* board) {
-    // 创建临时棋盘用于模拟
-    Board tempBoard;
-    memcpy(&tempBoard, board, sizeof(Board));
-    
-    // 模拟到当前节点的状态
-    MCTSNode* current = node;
-    while (current->parent) {
-        // 回溯到根节点，记录每一步
-        MCTSNode* moves[DEFAULT_MAX_DEPTH];
-        int moveCount = 0;
-        
-        MCTSNode* temp = current;
-        while (temp->parent) {
-            moves[moveCount++] = temp;
-            temp = temp->parent;
-        }
-        
-        // 按照正确顺序应用这些移动
-        for (int i = moveCount - 1; i >= 0; i--) {
-            placeStone(&tempBoard, moves[i]->move);
-        }
-        
-        current = current->parent;
+MCTSNode* expandNode(NodeArena* arena, MCTSNode* node, PlayoutBoard* pb, SearchContext* ctx) {
+    // 抢占扩展权，其他线程正在扩展或已经扩展时直接从该节点模拟
+    if (!SDL_AtomicCAS(&node->state, NODE_LEAF, NODE_EXPANDING)) {
+        return node;
     }
     
     // 获取所有合法落子位置 - 优化：考虑距离上次落子的范围
-    Position legalMoves[BOARD_SIZE * BOARD_SIZE];
+    int legalMoves[BOARD_SIZE * BOARD_SIZE];
     int legalMoveCount = 0;
     
     // 如果可以，在上一步落子的周围5×5范围内搜索
-    if (tempBoard.lastMove.x >= 0 && tempBoard.lastMove.y >= 0) {
-        getValidMovesInRange(&tempBoard, tempBoard.lastMove.x, tempBoard.lastMove.y, MCTS_RANGE_SMALL, legalMoves, &legalMoveCount);
+    if (pb->lastMove != NO_VERTEX) {
+        getPlayoutMovesInRange(pb, pb->lastMove, MCTS_RANGE_SMALL, legalMoves, &legalMoveCount);
     }
     
     // 如果在小范围内没有找到足够的落子点，考虑一些战略位置
@@ -221,19 +737,19 @@ MCTSNode* expandNode(MCTSNode* node, Board* board) {
         };
         
         for (int i = 0; i < 9; i++) {
-            Position pos = {starPoints[i][0], starPoints[i][1]};
-            if (isValidMove(&tempBoard, pos)) {
+            int move = VERTEX(starPoints[i][0], starPoints[i][1]);
+            if (playoutIsLegal(pb, move)) {
                 // 检查是否已经在列表中
                 bool exists = false;
                 for (int j = 0; j < legalMoveCount; j++) {
-                    if (legalMoves[j].x == pos.x && legalMoves[j].y == pos.y) {
+                    if (legalMoves[j] == move) {
                         exists = true;
                         break;
                     }
                 }
                 
                 if (!exists) {
-                    legalMoves[legalMoveCount++] = pos;
+                    legalMoves[legalMoveCount++] = move;
                 }
             }
         }
@@ -244,18 +760,18 @@ MCTSNode* expandNode(MCTSNode* node, Board* board) {
         for (int y = 0; y < BOARD_SIZE; y++) {
             for (int x = 0; x < BOARD_SIZE; x++) {
                 // 跳过已经在列表中的位置
+                int move = VERTEX(x, y);
                 bool exists = false;
                 for (int j = 0; j < legalMoveCount; j++) {
-                    if (legalMoves[j].x == x && legalMoves[j].y == y) {
+                    if (legalMoves[j] == move) {
                         exists = true;
                         break;
                     }
                 }
                 
                 if (!exists) {
-                    Position pos = {x, y};
-                    if (isValidMove(&tempBoard, pos)) {
-                        legalMoves[legalMoveCount++] = pos;
+                    if (playoutIsLegal(pb, move)) {
+                        legalMoves[legalMoveCount++] = move;
                         
                         // 如果已经找到足够多的落子点，就停止搜索
                         if (legalMoveCount >= 20) {
@@ -270,397 +786,614 @@ MCTSNode* expandNode(MCTSNode* node, Board* board) {
     
     // 如果没有合法落子，则返回当前节点
     if (legalMoveCount == 0) {
+        SDL_AtomicSet(&node->state, NODE_LEAF);
         return node;
     }
     
-    // 为每个合法落子创建子节点
-    node->childrenCount = legalMoveCount;
-    node->children = (MCTSNode**)malloc(sizeof(MCTSNode*) * legalMoveCount);
+    // 计算先验评分，按评分从高到低排列（候选点不多，插入排序即可）
+    double priors[BOARD_SIZE * BOARD_SIZE];
+    double priorTotal = 0.0;
+    for (int i = 0; i < legalMoveCount; i++) {
+        double prior = movePriorScore(pb, legalMoves[i]);
+        int move = legalMoves[i];
+        int j = i;
+        while (j > 0 && priors[j - 1] < prior) {
+            priors[j] = priors[j - 1];
+            legalMoves[j] = legalMoves[j - 1];
+            j--;
+        }
+        priors[j] = prior;
+        legalMoves[j] = move;
+        priorTotal += prior;
+    }
     
-    if (!node->children) {
-        node->childrenCount = 0;
+    // 记录候选落子表（一次分配一整块，统计已清零），子节点等到被选中时再创建
+    MCTSChildren* children = allocChildren(arena, legalMoveCount);
+    
+    // 节点池已满时不再扩展
+    if (!children) {
+        SDL_AtomicSet(&node->state, NODE_LEAF);
         return node;
     }
     
-    // 计算下一个玩家
-    Stone nextPlayer = (node->player == BLACK) ? WHITE : BLACK;
-    
-    // 创建子节点
     for (int i = 0; i < legalMoveCount; i++) {
-        node->children[i] = createChildNode(node, legalMoves[i], nextPlayer);
+        children->moves[i] = legalMoves[i];
+        children->priors[i] = (float)(priors[i] / priorTotal);
     }
+    node->children = children;
+    node->childrenCount = legalMoveCount;
+    
+    // 候选落子表写好后再发布，其他线程看到 NODE_EXPANDED 时表已完整
+    SDL_AtomicCAS(&node->state, NODE_EXPANDING, NODE_EXPANDED);
+    
+    // 先验概率最高的落子排在最前，扩展后先模拟它
+    MCTSNode* selected = materializeChild(arena, node, 0, pb);
+    if (!selected) return node;
     
-    // 改进：使用三种策略之一选择子节点
-    int strategy = rand() % 3;
-    int selectedIndex = 0;
+    // 轻量棋盘跟随到所选的子节点
+    addChildStat(&children->visits[0], 1);
+    SDL_AtomicAdd(&selected->visits, 1);
+    ctx->edges[ctx->pathLength] = 0;
+    ctx->path[ctx->pathLength++] = selected;
+    playoutPlay(pb, children->moves[0]);
     
-    if (strategy == 0) { // 随机选择
-        selectedIndex = rand() % legalMoveCount;
+    return selected;
+}
+
+/**
+ * @brief 重模拟策略：围绕对方最后一手依次寻找吃子、逃子和3×3模式的落子
+ * @param pb 轻量棋盘
+ * @param rng 随机数生成器
+ * @return 落子格点（都没有时为 NO_VERTEX，由随机落子补上）
+ */
+static int heavyPlayoutMove(PlayoutBoard* pb, Rng* rng) {
+    int last = pb->lastMove;
+    if (last == NO_VERTEX) return NO_VERTEX;
+    
+    Stone color = pb->currentPlayer;
+    int candidates[8];
+    int candidateCount = 0;
+    
+    // 吃子：对方刚落下的棋子组只剩一口气
+    if (pb->groups.groupLibs[pb->groups.groupId[last]] == 1) {
+        int liberty = playoutGroupLiberty(pb, last);
+        if (playoutIsLegal(pb, liberty)) return liberty;
     }
-    else if (strategy == 1 && tempBoard.lastMove.x >= 0) { // 边缘策略
-        // 找到距离上一个落子点最远的点
-        int parentX = tempBoard.lastMove.x;
-        int parentY = tempBoard.lastMove.y;
-        int maxDistance = 0;
+    
+    // 逃子：最后一手叫吃了己方棋子组，在剩下的那口气上长出去
+    for (int i = 0; i < 4; i++) {
+        int next = last + NEIGHBOR_OFFSETS[i];
+        if (pb->board[next] != color || pb->groups.groupLibs[pb->groups.groupId[next]] != 1) continue;
         
-        for (int i = 0; i < legalMoveCount; i++) {
-            int dx = legalMoves[i].x - parentX;
-            int dy = legalMoves[i].y - parentY;
-            int distance = dx*dx + dy*dy;
-            
-            if (distance > maxDistance) {
-                maxDistance = distance;
-                selectedIndex = i;
-            }
+        int liberty = playoutGroupLiberty(pb, next);
+        if (playoutIsLegal(pb, liberty) && !playoutIsSelfAtari(pb, liberty, color)) {
+            candidates[candidateCount++] = liberty;
         }
     }
-    else { // 中心策略
-        // 找到距离棋盘中心最近的点
-        int centerX = BOARD_SIZE / 2;
-        int centerY = BOARD_SIZE / 2;
-        int minDistance = BOARD_SIZE * BOARD_SIZE * 2;
+    if (candidateCount > 0) return candidates[rngBelow(rng, candidateCount)];
+    
+    // 模式：最后一手周围八个点中匹配3×3模式的落子
+    for (int i = 0; i < 8; i++) {
+        int next = last + NEIGHBOURHOOD_OFFSETS[i];
+        if (pb->board[next] != EMPTY || !playoutMatchesPattern(pb, next)) continue;
+        if (playoutIsEye(pb, next, color) || !playoutIsLegal(pb, next)) continue;
+        if (playoutIsSelfAtari(pb, next, color)) continue;
         
-        for (int i = 0; i < legalMoveCount; i++) {
-            int dx = legalMoves[i].x - centerX;
-            int dy = legalMoves[i].y - centerY;
-            int distance = dx*dx + dy*dy;
-            
-            // 额外考虑四个方向是否有自己的棋子，提高连接性
-            int connectedStones = 0;
-            for (int j = 0; j < 4; j++) {
-                int nx = legalMoves[i].x + DX[j];
-                int ny = legalMoves[i].y + DY[j];
-                if (nx >= 0 && nx < BOARD_SIZE && ny >= 0 && ny < BOARD_SIZE &&
-                    tempBoard.board[ny][nx] == node->player) {
-                    connectedStones++;
-                }
-            }
-            
-            // 减少距离以优先选择连接性好的位置
-            distance -= connectedStones * 5;
-            
-            if (distance < minDistance) {
-                minDistance = distance;
-                selectedIndex = i;
-            }
-        }
+        candidates[candidateCount++] = next;
     }
+    if (candidateCount > 0) return candidates[rngBelow(rng, candidateCount)];
     
-    return node->children[selectedIndex];
+    return NO_VERTEX;
 }
 
-double simulateGame(MCTSNode* node, Board* board, AIConfig* config) {
-    // 标记参数已使用
-    (void)config;
+/**
+ * @brief 取应手表中对方上一手的应手（不合法或会填自己的眼时不用）
+ * @param table 应手表
+ * @param pb 轻量棋盘
+ * @return 应手格点（没有可用的应手时为 NO_VERTEX）
+ */
+static int lastGoodReply(ReplyTable* table, const PlayoutBoard* pb) {
+    if (pb->lastMove == NO_VERTEX) return NO_VERTEX;
     
-    // 创建临时棋盘用于模拟
-    Board tempBoard;
-    memcpy(&tempBoard, board, sizeof(Board));
+    Stone color = pb->currentPlayer;
+    int reply = SDL_AtomicGet(&table->replies[color - BLACK][pb->lastMove]);
+    if (reply == NO_VERTEX || !playoutIsLegal(pb, reply) || playoutIsEye(pb, reply, color)) {
+        return NO_VERTEX;
+    }
     
-    // 模拟到当前节点的状态
-    MCTSNode* current = node;
-    while (current->parent) {
-        // 回溯到根节点，记录每一步
-        MCTSNode* moves[DEFAULT_MAX_DEPTH];
-        int moveCount = 0;
-        
-        MCTSNode* temp = current;
-        while (temp->parent) {
-            moves[moveCount++] = temp;
-            temp = temp->parent;
-        }
+    return reply;
+}
+
+/**
+ * @brief 按模拟结果更新应手表：获胜一方的应手记下，落败一方的应手如果在表中就忘掉
+ * @param table 应手表
+ * @param previous 模拟开始前的最后一手（NO_VERTEX 表示无）
+ * @param player 模拟中第一手的行棋方
+ * @param moves 模拟中依次走出的落子
+ * @param moveCount 落子数量
+ * @param winner 获胜的一方
+ */
+static void updateReplies(ReplyTable* table, int previous, Stone player, const int* moves, int moveCount, Stone winner) {
+    Stone color = player;
+    
+    for (int k = 0; k < moveCount; k++) {
+        int move = moves[k];
         
-        // 按照正确顺序应用这些移动
-        for (int i = moveCount - 1; i >= 0; i--) {
-            placeStone(&tempBoard, moves[i]->move);
+        // 先读一次，表项已经是要写的值时不做原子写
+        if (previous != NO_VERTEX && move != NO_VERTEX) {
+            SDL_atomic_t* slot = &table->replies[color - BLACK][previous];
+            int current = SDL_AtomicGet(slot);
+            if (color == winner) {
+                if (current != move) SDL_AtomicSet(slot, move);
+            } else if (current == move) {
+                SDL_AtomicCAS(slot, move, NO_VERTEX);
+            }
         }
         
-        current = current->parent;
+        previous = move;
+        color = (color == BLACK) ? WHITE : BLACK;
     }
+}
+
+double simulateGame(MCTSNode* node, PlayoutBoard* pb, SearchContext* ctx, int* moves, int* moveCount) {
+    Rng* rng = &ctx->rng;
+    ReplyTable* replies = ctx->config->lastGoodReply ? ctx->replies : NULL;
+    int previous = pb->lastMove;
     
-    // 减少模拟步数，提高速度
-    int maxMoves = 40 + (rand() % 20);  // 40-60步
-    int moveCount = 0;
-    Stone currentPlayer = node->player;
-    int prevBlackCaptured = tempBoard.blackCaptures;
-    int prevWhiteCaptured = tempBoard.whiteCaptures;
+    int played = 0;
+    int consecutivePasses = 0;
     
-    while (moveCount < maxMoves) {
-        // 获取所有有效移动 - 只考虑5×5范围内的移动以加快模拟
-        Position moves[BOARD_SIZE * BOARD_SIZE];
-        int validMoveCount = 0;
-        
-        if (tempBoard.lastMove.x >= 0 && tempBoard.lastMove.y >= 0) {
-            getValidMovesInRange(&tempBoard, tempBoard.lastMove.x, tempBoard.lastMove.y, MCTS_RANGE_SMALL, moves, &validMoveCount);
+    // 双方都不填自己的眼，一直下到双方连续停一手（步数上限只用来防止打劫循环）
+    while (consecutivePasses < 2 && played < MCTS_MAX_PLAYOUT_MOVES) {
+        // 先试之前获胜过的应手；重模拟再找有针对性的落子，否则从空点表中均匀随机地选择，不需要逐点扫描
+        int move = NO_VERTEX;
+        if (replies) {
+            move = lastGoodReply(replies, pb);
         }
-        
-        // 如果找不到有效移动，扩大搜索范围
-        if (validMoveCount == 0) {
-            for (int attempts = 0; attempts < 10 && validMoveCount == 0; attempts++) {
-                int x = rand() % BOARD_SIZE;
-                int y = rand() % BOARD_SIZE;
-                Position pos = {x, y};
-                if (isValidMove(&tempBoard, pos)) {
-                    moves[validMoveCount++] = pos;
-                }
-            }
+        if (move == NO_VERTEX && ctx->config->playoutPolicy == PLAYOUT_HEAVY) {
+            move = heavyPlayoutMove(pb, rng);
         }
-        
-        // 如果没有有效移动，结束模拟
-        if (validMoveCount == 0) {
-            break;
+        if (move == NO_VERTEX) {
+            move = playoutRandomMove(pb, rng);
         }
         
-        // 简单随机选择，不使用启发式以提高速度
-        int selectedMove = rand() % validMoveCount;
-        Position movePos = moves[selectedMove];
-        
-        // 走子
-        placeStone(&tempBoard, movePos);
-        
-        moveCount++;
-        
-        // 如果连续5步都没有提子，提前结束模拟
-        if (moveCount > 20 && moveCount % 5 == 0) {
-            bool shouldEnd = true;
-            if (tempBoard.blackCaptures != prevBlackCaptured || 
-                tempBoard.whiteCaptures != prevWhiteCaptured) {
-                shouldEnd = false;
-            }
-            
-            if (shouldEnd) break;
-            
-            prevBlackCaptured = tempBoard.blackCaptures;
-            prevWhiteCaptured = tempBoard.whiteCaptures;
+        // 没有可下的点时停一手
+        if (move == NO_VERTEX) {
+            playoutPass(pb);
+            consecutivePasses++;
+        } else {
+            playoutPlay(pb, move);
+            consecutivePasses = 0;
         }
         
-        // 切换玩家
-        currentPlayer = (currentPlayer == BLACK) ? WHITE : BLACK;
+        // 停一手也记录，保持双方交替
+        moves[played++] = move;
     }
     
-    // 简化评分计算，减少计算开销
-    double score;
+    *moveCount = played;
     
-    // 提子加权评分 - 使用黑方和白方的提子数作为评分
-    int blackScore = tempBoard.blackCaptures;
-    int whiteScore = tempBoard.whiteCaptures;
+    // 终局按数子法计算胜负，白方加上贴目
+    double margin = playoutScore(pb) - ctx->config->komi;
+    Stone winner = (margin > 0) ? BLACK : WHITE;
     
-    // 根据当前玩家返回相应评分
-    if ((int)node->player == BLACK) {
-        score = (blackScore > whiteScore) ? 1.0 : 0.0;
-    } else {
-        score = (whiteScore > blackScore) ? 1.0 : 0.0;
+    if (replies) {
+        updateReplies(replies, previous, node->player, moves, played, winner);
     }
     
-    return score;
+    // 从开始模拟节点的行棋方角度返回结果
+    return (winner == node->player) ? 1.0 : 0.0;
 }
 
-void backpropagate(MCTSNode* node, double result) {
-    MCTSNode* current = node;
+void backpropagate(SearchContext* ctx, double result, const int* moves, int moveCount) {
+    if (ctx->pathLength == 0) return;
+    
+    Stone player = ctx->path[ctx->pathLength - 1]->player;
+    Stone opponent = (player == BLACK) ? WHITE : BLACK;
+    Stone winner = (result > 0.5) ? player : opponent;
     
-    while (current) {
-        current->visits++;
+    // 每个格点在当前位置之后第一次由哪一方落子（从后往前覆盖，留下的就是最早的一次）
+    uint8_t firstMover[BOARD_VERTICES];
+    memset(firstMover, EMPTY, sizeof(firstMover));
+    for (int k = moveCount - 1; k >= 0; k--) {
+        firstMover[moves[k]] = (uint8_t)((k % 2 == 0) ? player : opponent);
+    }
+    
+    // 沿实际经过的边更新：置换节点在树结构上的父节点不一定是这次的来路
+    for (int i = ctx->pathLength - 1; i >= 0; i--) {
+        MCTSNode* current = ctx->path[i];
         
-        // 更新胜率（从各自玩家角度）
-        if (current->player == node->player) {
-            current->wins += result;
-        } else {
-            current->wins += (1.0 - result);
+        // 当前行棋方在之后先下过的落子，计入对应候选落子的 AMAF 统计
+        if (SDL_AtomicGet(&current->state) == NODE_EXPANDED) {
+            MCTSChildren* children = current->children;
+            for (int j = 0; j < current->childrenCount; j++) {
+                if (firstMover[children->moves[j]] != current->player) continue;
+                
+                addChildStat(&children->amafVisits[j], 1);
+                if (current->player == winner) {
+                    addChildStat(&children->amafWins[j], 1);
+                }
+            }
         }
         
-        current = current->parent;
+        if (i == 0) break;
+        
+        // 胜利次数记给走出这一步的一方（即上一个节点的行棋方），父节点选择时直接比较
+        // 访问次数已在选择时计入
+        MCTSNode* parent = ctx->path[i - 1];
+        int edge = ctx->edges[i];
+        if (parent->player == winner) {
+            addChildStat(&parent->children->wins[edge], 1);
+        }
+        
+        // 这一步对上一层来说也是之后的落子
+        firstMover[parent->children->moves[edge]] = (uint8_t)parent->player;
     }
 }
 
-MCTSNode* selectBestChild(MCTSNode* node, AIConfig* config) {
+int selectBestChild(MCTSNode* node, AIConfig* config) {
     (void)config; // 标记参数已使用
     
     if (!node || node->childrenCount == 0) {
-        return NULL;
+        return -1;
     }
     
-    MCTSNode* bestChild = NULL;
-    double bestScore = -INFINITY;
+    int bestChild = -1;
+    int bestVisits = 0;
     
-    // 选择访问次数最多的子节点（最可靠的选择）
+    // 选择访问次数最多的候选落子（最可靠的选择），没有访问过的落子不参与
     for (int i = 0; i < node->childrenCount; i++) {
-        if (node->children[i]->visits > bestScore) {
-            bestScore = node->children[i]->visits;
-            bestChild = node->children[i];
+        int visits = getChildStat(&node->children->visits[i]);
+        if (visits > bestVisits) {
+            bestVisits = visits;
+            bestChild = i;
         }
     }
     
     return bestChild;
 }
 
-void runMCTS(Board* board, AIConfig* config, MCTSNode* root) {
-    // 使用时间限制而不是固定迭代次数
-    Uint32 startTime = SDL_GetTicks();
-    int iterations = 0;
-    
-    while (iterations < config->simulationCount && (SDL_GetTicks() - startTime) < MCTS_TIME_LIMIT) {
+// 一次搜索中所有搜索线程共享的参数和计数
+typedef struct {
+    const PlayoutBoard* rootBoard;
+    AIConfig* config;
+    int maxIterations;
+    Uint32 startTime;
+    Uint32 timeLimit;
+    SDL_atomic_t* stop;
+    SDL_atomic_t* playouts;
+    SDL_atomic_t* treeFull;
+    SDL_atomic_t claimed;         // 已领取的迭代次数
+    SDL_atomic_t completed;       // 已完成的迭代次数
+    ReplyTable replies;           // 本次搜索共享的应手表
+} SearchJob;
+
+// 单个搜索线程
+typedef struct {
+    SearchJob* job;               // 共享的搜索参数
+    NodeArena* arena;             // 搜索所用的节点池
+    MCTSNode* root;               // 搜索所用的根节点
+    NodeArena ownArena;           // 根并行时线程独占的节点池
+    int ownArenaNodes;            // 独占节点池的容量
+    SearchContext ctx;            // 线程上下文
+} SearchWorker;
+
+/**
+ * @brief 搜索线程主循环：不断领取迭代并执行，直到次数用完、超时或收到停止请求
+ * @param job 共享的搜索参数
+ * @param arena 节点池
+ * @param root 根节点
+ * @param ctx 线程上下文
+ */
+static void runSearchLoop(SearchJob* job, NodeArena* arena, MCTSNode* root, SearchContext* ctx) {
+    while (true) {
+        if (job->timeLimit > 0 && (SDL_GetTicks() - job->startTime) >= job->timeLimit) break;
+        if (job->stop && SDL_AtomicGet(job->stop)) break;
+        if (SDL_AtomicAdd(&job->claimed, 1) >= job->maxIterations) break;
+        
+        // 节点池用满后树不再生长，继续模拟只是空转
+        if (job->treeFull && (SDL_AtomicGet(job->treeFull) || nodeArenaFull(arena))) {
+            SDL_AtomicSet(job->treeFull, 1);
+            break;
+        }
+        
+        // 每次迭代从根局面出发，选择、扩展和模拟共用同一块棋盘
+        PlayoutBoard scratch = *job->rootBoard;
+        
         // 选择阶段
-        MCTSNode* selected = selectNode(root, config);
+        MCTSNode* selected = selectNode(arena, root, ctx, &scratch);
         
         // 扩展阶段
-        MCTSNode* expanded = expandNode(selected, board);
+        MCTSNode* expanded = expandNode(arena, selected, &scratch, ctx);
         
         // 模拟阶段
-        double result = simulateGame(expanded, board, config);
+        int moves[MCTS_MAX_PLAYOUT_MOVES];
+        int moveCount = 0;
+        double result = simulateGame(expanded, &scratch, ctx, moves, &moveCount);
         
         // 反向传播阶段
-        backpropagate(expanded, result);
+        backpropagate(ctx, result, moves, moveCount);
         
-        iterations++;
+        SDL_AtomicAdd(&job->completed, 1);
+        if (job->playouts) SDL_AtomicAdd(job->playouts, 1);
     }
 }
 
-Position findBestMove(Board* board, AIConfig* config) {
-    // 初始化随机数生成器
-    srand((unsigned)time(NULL));
+/**
+ * @brief 辅助搜索线程入口（根并行时先在独占的节点池中建立自己的根节点）
+ */
+static int searchWorker(void* data) {
+    SearchWorker* worker = (SearchWorker*)data;
     
-    // 创建根节点
-    MCTSNode* root = createRootNode(board);
+    if (!worker->root) {
+        if (!initNodeArena(&worker->ownArena, worker->ownArenaNodes)) return 0;
+        worker->arena = &worker->ownArena;
+        worker->root = allocNodes(worker->arena, 1);
+        initNode(worker->root, NULL, NO_VERTEX, worker->job->rootBoard->currentPlayer,
+                 playoutKey(worker->job->rootBoard));
+    }
     
-    // 获取有效移动 - 优化：第一种情况：如果是游戏开始则考虑天元和星位
-    Position validMoves[BOARD_SIZE * BOARD_SIZE];
-    int validMoveCount = 0;
+    runSearchLoop(worker->job, worker->arena, worker->root, &worker->ctx);
+    return 0;
+}
+
+/**
+ * @brief 在候选落子表中查找指定落子
+ * @param node 父节点
+ * @param move 落子格点
+ * @return 候选落子的下标（没有时为 -1）
+ */
+static int findChild(MCTSNode* node, int move) {
+    for (int i = 0; i < node->childrenCount; i++) {
+        if (node->children->moves[i] == move) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief 把另一棵树的统计按落子逐层合并到本树对应局面的节点和边上
+ *
+ * 本树没有展开过的节点复制另一棵树的候选落子表，边的统计直接累加；另一棵树创建过而本树没有的子节点
+ * 在本树的节点池中创建，新节点与选择时一样查找置换表，局面已经出现过时合并到已有节点上。
+ * 节点池用满后不再向下合并，已经累加的统计仍然有效。
+ * @param arena 本树的节点池
+ * @param node 接收统计的节点
+ * @param other 另一棵树中对应同一局面的节点
+ */
+static void mergeTreeStats(NodeArena* arena, MCTSNode* node, MCTSNode* other) {
+    SDL_AtomicAdd(&node->visits, SDL_AtomicGet(&other->visits));
+    if (other->childrenCount == 0) return;
     
-    // 如果是第一步（没有历史移动），优先选择天元和星位
-    if (board->lastMove.x < 0 || board->lastMove.y < 0) {
-        // 天元 (棋盘中心)
-        int center = BOARD_SIZE / 2;
-        Position centerPos = {center, center};
-        if (isValidMove(board, centerPos)) {
-            validMoves[validMoveCount++] = centerPos;
-        }
-        
-        // 星位点
-        int starPoints[][2] = {
-            {3, 3}, {3, BOARD_SIZE-4}, {BOARD_SIZE-4, 3}, {BOARD_SIZE-4, BOARD_SIZE-4},
-            {3, center}, {center, 3}, {BOARD_SIZE-4, center}, {center, BOARD_SIZE-4}
-        };
-        
-        for (int i = 0; i < 8; i++) {
-            Position pos = {starPoints[i][0], starPoints[i][1]};
-            if (isValidMove(board, pos)) {
-                validMoves[validMoveCount++] = pos;
-            }
-        }
+    MCTSChildren* source = other->children;
+    if (node->childrenCount == 0) {
+        MCTSChildren* children = allocChildren(arena, other->childrenCount);
+        if (!children) return;
         
-        // 如果有有效的天元或星位，直接随机选择一个
-        if (validMoveCount > 0) {
-            int randomIndex = rand() % validMoveCount;
-            Position bestMove = validMoves[randomIndex];
-            
-            // 释放树
-            freeMCTSTree(root);
-        //打印MCTS搜索信息
-            printf("MCTS: Found best move at (%d, %d) in first turn.\n", bestMove.x, bestMove.y);
-            
-            return bestMove;
-        }
+        memcpy(children->moves, source->moves, sizeof(int) * other->childrenCount);
+        memcpy(children->priors, source->priors, sizeof(float) * other->childrenCount);
+        node->children = children;
+        node->childrenCount = other->childrenCount;
+        SDL_AtomicSet(&node->state, NODE_EXPANDED);
     }
     
-    // 第二种情况：在对手上次落子的5×5范围内搜索
-    if (board->lastMove.x >= 0 && board->lastMove.y >= 0) {
-        getValidMovesInRange(board, board->lastMove.x, board->lastMove.y, MCTS_RANGE_SMALL, validMoves, &validMoveCount);
-        
-        // 保存可用的有效落子点，用于超时情况
-        Position backupMoves[BOARD_SIZE * BOARD_SIZE];
-        int backupCount = validMoveCount;
-        memcpy(backupMoves, validMoves, validMoveCount * sizeof(Position));
+    // 同一局面展开出的候选落子相同，按落子逐个对应
+    MCTSChildren* target = node->children;
+    for (int i = 0; i < other->childrenCount; i++) {
+        int j = findChild(node, source->moves[i]);
+        if (j < 0) continue;
         
-        // 运行MCTS
-        runMCTS(board, config, root);
+        addChildStat(&target->visits[j], getChildStat(&source->visits[i]));
+        addChildStat(&target->wins[j], getChildStat(&source->wins[i]));
+        addChildStat(&target->amafVisits[j], getChildStat(&source->amafVisits[i]));
+        addChildStat(&target->amafWins[j], getChildStat(&source->amafWins[i]));
+        if (!source->nodes[i]) continue;
         
-        // 选择最佳子节点
-        MCTSNode* bestChild = selectBestChild(root, config);
+        MCTSNode* child = target->nodes[j] ? target->nodes[j] : createChild(arena, node, j, source->nodes[i]->key);
+        if (child) mergeTreeStats(arena, child, source->nodes[i]);
+    }
+}
+
+int runMCTSIterations(const PlayoutBoard* rootBoard, AIConfig* config, NodeArena* arena, MCTSNode* root,
+                      int maxIterations, Uint32 timeLimit, SDL_atomic_t* stop, SDL_atomic_t* playouts,
+                      SDL_atomic_t* treeFull) {
+    SearchJob job;
+    job.rootBoard = rootBoard;
+    job.config = config;
+    job.maxIterations = maxIterations;
+    job.startTime = SDL_GetTicks();
+    job.timeLimit = timeLimit;
+    job.stop = stop;
+    job.playouts = playouts;
+    job.treeFull = treeFull;
+    SDL_AtomicSet(&job.claimed, 0);
+    SDL_AtomicSet(&job.completed, 0);
+    
+    // 应手表只在本次搜索内有效，辅助线程启动前清空
+    memset(&job.replies, 0, sizeof(job.replies));
+    
+    // 每个线程使用同一种子下各自的随机数流
+    uint64_t seed = searchSeed(config);
+    SearchContext ctx;
+    ctx.config = config;
+    ctx.replies = &job.replies;
+    seedRng(&ctx.rng, seed, 0);
+    
+    // 启动辅助线程，调用线程自己也参与搜索；线程创建失败时用已有的线程继续
+    int helperCount = config->threadCount - 1;
+    if (helperCount > MCTS_MAX_THREADS - 1) helperCount = MCTS_MAX_THREADS - 1;
+    
+    // 根并行的临时树每次迭代最多新建一个节点，按平均每个线程分到的迭代次数的两倍分配，
+    // 不必为每次短搜索分配完整的节点池；超出份额的线程树不再生长，只继续累加统计
+    int share = maxIterations / (helperCount + 1);
+    int helperNodes = MCTS_ARENA_NODES;
+    if (share < (MCTS_ARENA_NODES - MCTS_HELPER_ARENA_MIN) / 2) {
+        helperNodes = 2 * share + MCTS_HELPER_ARENA_MIN;
+    }
+    
+    SDL_Thread* helpers[MCTS_MAX_THREADS];
+    SearchWorker workers[MCTS_MAX_THREADS];
+    int started = 0;
+    for (int i = 0; i < helperCount; i++) {
+        SearchWorker* worker = &workers[started];
+        worker->job = &job;
+        worker->ownArena.nodes = NULL;
+        worker->ownArenaNodes = helperNodes;
+        worker->ctx.config = config;
+        worker->ctx.replies = &job.replies;
+        seedRng(&worker->ctx.rng, seed, (uint64_t)i + 1);
         
-        // 获取最佳落子位置
-        Position bestMove;
-        if (bestChild) {
-            bestMove = bestChild->move;
-        } else if (backupCount > 0) {
-            // 如果MCTS失败，从备份中随机选择
-            int randomIndex = rand() % backupCount;
-            bestMove = backupMoves[randomIndex];
+        // 根并行的线程在自己的线程中建树，避免主线程串行分配
+        if (config->parallelMode == PARALLEL_ROOT) {
+            worker->arena = NULL;
+            worker->root = NULL;
         } else {
-            // 如果没有有效落子，返回无效位置
-            bestMove.x = -1;
-            bestMove.y = -1;
+            worker->arena = arena;
+            worker->root = root;
         }
         
-        // 释放树
-        freeMCTSTree(root);
+        helpers[started] = SDL_CreateThread(searchWorker, "mcts", worker);
+        if (helpers[started]) started++;
+    }
+    
+    runSearchLoop(&job, arena, root, &ctx);
+    
+    for (int i = 0; i < started; i++) {
+        SDL_WaitThread(helpers[i], NULL);
         
-        return bestMove;
+        if (workers[i].ownArena.nodes) {
+            if (workers[i].root) mergeTreeStats(arena, root, workers[i].root);
+            freeNodeArena(&workers[i].ownArena);
+        }
     }
     
-    // 如果没有历史移动或可用的有效位置，获取所有合法移动
-    validMoveCount = getLegalMoves(board, validMoves);
+    return SDL_AtomicGet(&job.completed);
+}
+
+void runMCTS(Board* board, AIConfig* config, NodeArena* arena, MCTSNode* root) {
+    // 节点池不可用时没有可搜索的树
+    if (!root) return;
     
-    // 如果没有合法移动，返回无效位置
-    if (validMoveCount == 0) {
-        Position invalidMove = {-1, -1};
-        freeMCTSTree(root);
-        return invalidMove;
+    // 搜索只在轻量棋盘上进行，不触碰对局的历史记录
+    PlayoutBoard rootBoard;
+    initPlayoutBoard(&rootBoard, board);
+    
+    // 使用时间限制而不是固定迭代次数
+    runMCTSIterations(&rootBoard, config, arena, root, config->simulationCount, config->timeLimit, NULL, NULL, NULL);
+}
+
+int chooseOpeningMove(Board* board, AIConfig* config) {
+    // 只在第一步（没有历史移动）时使用
+    if (board->lastMove != NO_VERTEX) {
+        return NO_VERTEX;
     }
     
-    // 运行MCTS
-    runMCTS(board, config, root);
+    int validMoves[BOARD_SIZE * BOARD_SIZE];
+    int validMoveCount = 0;
     
-    // 选择最佳子节点
-    MCTSNode* bestChild = selectBestChild(root, config);
+    // 天元 (棋盘中心)
+    int center = BOARD_SIZE / 2;
+    if (isValidMove(board, VERTEX(center, center))) {
+        validMoves[validMoveCount++] = VERTEX(center, center);
+    }
     
-    // 获取最佳落子位置
-    Position bestMove;
-    if (bestChild) {
-        bestMove = bestChild->move;
-    } else {
-        // 如果没有找到最佳落子，随机选择一个合法位置
-        int randomIndex = rand() % validMoveCount;
-        bestMove = validMoves[randomIndex];
+    // 星位点
+    int starPoints[][2] = {
+        {3, 3}, {3, BOARD_SIZE-4}, {BOARD_SIZE-4, 3}, {BOARD_SIZE-4, BOARD_SIZE-4},
+        {3, center}, {center, 3}, {BOARD_SIZE-4, center}, {center, BOARD_SIZE-4}
+    };
+    
+    for (int i = 0; i < 8; i++) {
+        int move = VERTEX(starPoints[i][0], starPoints[i][1]);
+        if (isValidMove(board, move)) {
+            validMoves[validMoveCount++] = move;
+        }
     }
     
-    // 释放树
-    freeMCTSTree(root);
-    //打印MCTS搜索信息
-    printf("MCTS: Found best move at (%d, %d) after %d iterations.\n", bestMove.x, bestMove.y, config->simulationCount);
-    return bestMove;
+    // 如果有有效的天元或星位，直接随机选择一个
+    if (validMoveCount == 0) {
+        return NO_VERTEX;
+    }
+    
+    Rng rng;
+    seedRng(&rng, searchSeed(config), 0);
+    
+    return validMoves[rngBelow(&rng, validMoveCount)];
 }
 
 /**
- * @brief 执行AI落子（适用于当前玩家，无论黑白）
- * @param game 游戏指针
- * @return 落子是否成功
+ * @brief 按访问次数从高到低检查根节点的子节点，返回第一个符合完整规则的落子
+ *
+ * 搜索只检查简单劫，访问最多的落子可能违反全局同形，这时依次改用访问次数较少的落子。
+ * @param root 根节点
+ * @param board 当前棋盘状态
+ * @return 落子格点（根节点没有可用的子节点时为 NO_VERTEX）
  */
-bool makeAIMoveForCurrentPlayer(Game* game) {
-    // 如果游戏未在进行中，则不处理
-    if (game->state != STATE_PLAYING) {
-        return false;
+static int mostVisitedValidMove(MCTSNode* root, Board* board) {
+    if (!root || root->childrenCount == 0) return NO_VERTEX;
+    
+    // 按访问次数从高到低排列候选落子（插入排序，访问次数相同时保持原来的顺序），没有访问过的落子不参与
+    MCTSChildren* children = root->children;
+    int order[BOARD_SIZE * BOARD_SIZE];
+    int count = 0;
+    for (int i = 0; i < root->childrenCount; i++) {
+        int visits = getChildStat(&children->visits[i]);
+        if (visits == 0) continue;
+        
+        int j = count++;
+        while (j > 0 && getChildStat(&children->visits[order[j - 1]]) < visits) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        if (isValidMove(board, children->moves[order[i]])) return children->moves[order[i]];
+    }
+    
+    return NO_VERTEX;
+}
+
+int pickSearchMove(SearchTree* tree, Board* board, AIConfig* config) {
+    // 搜索只检查简单劫，最终落子还要经过完整规则（全局同形）的检查
+    int bestMove = mostVisitedValidMove(tree->root, board);
+    if (bestMove != NO_VERTEX) {
+        return bestMove;
     }
     
-    // 标记AI正在思考
-    game->aiThinking = true;
+    // 如果MCTS失败，优先在对手上次落子的5×5范围内随机选择
+    int validMoves[BOARD_SIZE * BOARD_SIZE];
+    int validMoveCount = 0;
+    
+    if (board->lastMove != NO_VERTEX) {
+        getValidMovesInRange(board, board->lastMove, MCTS_RANGE_SMALL, validMoves, &validMoveCount);
+    }
     
-    // 初始化AI配置
-    AIConfig config;
-    initAIConfig(&config);
+    // 否则从所有合法移动中随机选择
+    if (validMoveCount == 0) {
+        validMoveCount = getLegalMoves(board, validMoves);
+    }
     
-    // 使用蒙特卡洛树搜索找到最佳落子位置
-    Position bestMove = findBestMove(&game->board, &config);
+    // 如果没有有效落子，返回无效位置
+    if (validMoveCount == 0) {
+        return NO_VERTEX;
+    }
     
-    // 尝试落子
-    bool success = placeStone(&game->board, bestMove);
+    Rng rng;
+    seedRng(&rng, searchSeed(config), 0);
     
-    // 如果落子成功，更新游戏状态
-    if (success) {
-        updateGame(game);
+    return validMoves[rngBelow(&rng, validMoveCount)];
+}
+
+int findBestMove(SearchTree* tree, Board* board, AIConfig* config) {
+    // 如果是游戏开始则考虑天元和星位
+    int openingMove = chooseOpeningMove(board, config);
+    if (openingMove != NO_VERTEX) {
+        return openingMove;
     }
     
-    // AI思考结束
-    game->aiThinking = false;
+    // 运行MCTS（尽量沿用上一回合的搜索树）
+    MCTSNode* root = advanceSearchTree(tree, board);
+    runMCTS(board, config, &tree->arenas[tree->activeArena], root);
     
-    return success;
-}
\ No newline at end of file
+    return pickSearchMove(tree, board, config);
+}
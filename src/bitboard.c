@@ -0,0 +1,94 @@
+/**
+ * @file bitboard.c
+ * @brief 位棋盘操作实现
+ */
+
+#include "../include/bitboard.h"
+
+// 棋盘内全部格点的掩码
+static Bitboard onBoardMask;
+static bool tablesReady = false;
+
+void initBitboardTables(void) {
+    if (tablesReady) return;
+    
+    bbClear(&onBoardMask);
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            bbSetBit(&onBoardMask, VERTEX(x, y));
+        }
+    }
+    
+    tablesReady = true;
+}
+
+const Bitboard* bbOnBoard(void) {
+    return &onBoardMask;
+}
+
+/**
+ * @brief 整体左移（向编号大的方向）
+ */
+static inline void shiftUp(const Bitboard* b, int shift, Bitboard* out) {
+    out->w[0] = b->w[0] << shift;
+    for (int i = 1; i < BITBOARD_WORDS; i++) {
+        out->w[i] = (b->w[i] << shift) | (b->w[i - 1] >> (64 - shift));
+    }
+}
+
+/**
+ * @brief 整体右移（向编号小的方向）
+ */
+static inline void shiftDown(const Bitboard* b, int shift, Bitboard* out) {
+    for (int i = 0; i < BITBOARD_WORDS - 1; i++) {
+        out->w[i] = (b->w[i] >> shift) | (b->w[i + 1] << (64 - shift));
+    }
+    out->w[BITBOARD_WORDS - 1] = b->w[BITBOARD_WORDS - 1] >> shift;
+}
+
+/**
+ * @brief 计算自身加四个方向的膨胀结果（未限制在棋盘内）
+ */
+static inline void dilate(const Bitboard* b, Bitboard* out) {
+    Bitboard left, right, up, down;
+    
+    shiftDown(b, 1, &left);
+    shiftUp(b, 1, &right);
+    shiftDown(b, BOARD_STRIDE, &up);
+    shiftUp(b, BOARD_STRIDE, &down);
+    
+    for (int i = 0; i < BITBOARD_WORDS; i++) {
+        out->w[i] = b->w[i] | left.w[i] | right.w[i] | up.w[i] | down.w[i];
+    }
+}
+
+void bbNeighbors(const Bitboard* b, Bitboard* out) {
+    Bitboard grown;
+    dilate(b, &grown);
+    
+    for (int i = 0; i < BITBOARD_WORDS; i++) {
+        out->w[i] = grown.w[i] & ~b->w[i] & onBoardMask.w[i];
+    }
+}
+
+void bbFloodFill(const Bitboard* seed, const Bitboard* mask, Bitboard* out) {
+    Bitboard current;
+    bbAnd(seed, mask, &current);
+    
+    // 每轮向四周扩散一格，直到区域不再增长
+    while (true) {
+        Bitboard grown;
+        dilate(&current, &grown);
+        
+        uint64_t changed = 0;
+        for (int i = 0; i < BITBOARD_WORDS; i++) {
+            uint64_t next = grown.w[i] & mask->w[i];
+            changed |= next ^ current.w[i];
+            current.w[i] = next;
+        }
+        
+        if (!changed) break;
+    }
+    
+    *out = current;
+}
\ No newline at end of file
@@ -6,57 +6,280 @@
 #include "../include/board.h"
 #include <string.h>
 
-// 方向数组，用于检查相邻位置
-static const int DX[4] = {-1, 0, 1, 0};
-static const int DY[4] = {0, -1, 0, 1};
+// 方向数组，用于检查相邻格点（左、上、右、下）
+const int NEIGHBOR_OFFSETS[4] = {-1, -BOARD_STRIDE, 1, BOARD_STRIDE};
+
+// Zobrist 随机数表
+uint64_t zobristKeys[3][BOARD_VERTICES];
+
+// 空棋盘的哈希值（非零，使 0 可以作为哈希集合的空槽标记）
+static const uint64_t EMPTY_BOARD_HASH = 0x9E3779B97F4A7C15ULL;
+
+void initZobrist(void) {
+    static bool initialized = false;
+    if (initialized) return;
+    
+    // 使用固定种子的 splitmix64，保证每次运行哈希值一致
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    for (int color = 0; color < 3; color++) {
+        for (int v = 0; v < BOARD_VERTICES; v++) {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            zobristKeys[color][v] = z ^ (z >> 31);
+        }
+    }
+    
+    initialized = true;
+}
 
 /**
- * @brief 检查位置是否在棋盘范围内
+ * @brief 检查局面是否在本局出现过
  */
-static bool isValidPosition(Position pos) {
-    return pos.x >= 0 && pos.x < BOARD_SIZE && pos.y >= 0 && pos.y < BOARD_SIZE;
+static bool positionSeen(Board* board, uint64_t hash) {
+    // 集合无法扩容而漏记了局面时，改为沿历史记录逐个比较（棋局路线上的局面互不相同）
+    if (board->current && board->seenCount < board->current->moveNumber + 1) {
+        for (BoardHistory* node = board->current; node; node = node->prev) {
+            if (node->hash == hash) return true;
+        }
+        return false;
+    }
+    
+    if (board->seenCapacity == 0) return false;
+    
+    int mask = board->seenCapacity - 1;
+    int slot = (int)(hash & mask);
+    
+    // 线性探测，遇到空槽即结束
+    while (board->seenPositions[slot] != 0) {
+        if (board->seenPositions[slot] == hash) return true;
+        slot = (slot + 1) & mask;
+    }
+    
+    return false;
 }
 
 /**
- * @brief 创建新的历史记录节点
+ * @brief 把局面集合的槽数加倍并重新插入已有的局面
+ * @return 是否成功（内存不足时保留原来的集合）
  */
-static BoardHistory* createHistoryNode(Board* board) {
-    BoardHistory* node = (BoardHistory*)malloc(sizeof(BoardHistory));
+static bool growSeenPositions(Board* board) {
+    int capacity = board->seenCapacity ? board->seenCapacity * 2 : POSITION_SET_SIZE;
+    uint64_t* slots = (uint64_t*)calloc(capacity, sizeof(uint64_t));
+    if (!slots) return false;
+    
+    int mask = capacity - 1;
+    for (int i = 0; i < board->seenCapacity; i++) {
+        uint64_t hash = board->seenPositions[i];
+        if (hash == 0) continue;
+        
+        int slot = (int)(hash & mask);
+        while (slots[slot] != 0) slot = (slot + 1) & mask;
+        slots[slot] = hash;
+    }
+    
+    free(board->seenPositions);
+    board->seenPositions = slots;
+    board->seenCapacity = capacity;
+    return true;
+}
+
+/**
+ * @brief 记录出现过的局面
+ */
+static void addSeenPosition(Board* board, uint64_t hash) {
+    // 超过四分之三容量时先扩容，保证探测序列总能遇到空槽
+    if ((board->seenCount + 1) * 4 > board->seenCapacity * 3 && !growSeenPositions(board)) return;
+    
+    int mask = board->seenCapacity - 1;
+    int slot = (int)(hash & mask);
+    while (board->seenPositions[slot] != 0) {
+        if (board->seenPositions[slot] == hash) return;
+        slot = (slot + 1) & mask;
+    }
+    
+    board->seenPositions[slot] = hash;
+    board->seenCount++;
+}
+
+/**
+ * @brief 删除记录的局面（悔棋时使用）
+ */
+static void removeSeenPosition(Board* board, uint64_t hash) {
+    if (board->seenCapacity == 0) return;
+    
+    int mask = board->seenCapacity - 1;
+    int slot = (int)(hash & mask);
+    while (board->seenPositions[slot] != hash) {
+        if (board->seenPositions[slot] == 0) return;
+        slot = (slot + 1) & mask;
+    }
+    
+    // 向后移动同一探测链上的元素，填补删除留下的空槽
+    int hole = slot;
+    int next = (hole + 1) & mask;
+    while (board->seenPositions[next] != 0) {
+        int home = (int)(board->seenPositions[next] & mask);
+        
+        // 如果 next 的理想位置不在 (hole, next] 区间内，就可以移到 hole
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            board->seenPositions[hole] = board->seenPositions[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    
+    board->seenPositions[hole] = 0;
+    board->seenCount--;
+}
+
+/**
+ * @brief 检查格点是否在棋盘范围内
+ */
+static bool isValidVertex(Board* board, int vertex) {
+    return vertex > 0 && vertex < BOARD_VERTICES && board->board[vertex] != OFFBOARD;
+}
+
+/**
+ * @brief 创建新的历史记录节点（记录本手的变化，关键帧节点另存完整棋盘）
+ */
+static BoardHistory* createHistoryNode(Board* board, int moveNumber, int vertex, Stone color,
+                                       const int16_t* captured, int capturedCount) {
+    BoardHistory* node = (BoardHistory*)malloc(sizeof(BoardHistory) + capturedCount * sizeof(int16_t));
     if (!node) return NULL;
     
-    // 复制当前棋盘状态
-    memcpy(node->board, board->board, sizeof(board->board));
-    node->lastMove = board->lastMove;
-    node->blackCaptures = board->blackCaptures;
-    node->whiteCaptures = board->whiteCaptures;
-    node->blackLiberties = board->blackLiberties;
-    node->whiteLiberties = board->whiteLiberties;
     node->prev = NULL;
     node->next = NULL;
+    node->keyframe = NULL;
+    node->hash = board->hash;
+    node->moveNumber = moveNumber;
+    node->move = (int16_t)vertex;
+    node->koPosition = (int16_t)board->koPosition;
+    node->color = (uint8_t)color;
+    node->koActive = board->koActive;
+    node->capturedCount = (int16_t)capturedCount;
+    if (capturedCount > 0) {
+        memcpy(node->captured, captured, capturedCount * sizeof(int16_t));
+    }
+    
+    // 每隔固定手数保存一份完整棋盘，用于快速跳转
+    if (moveNumber % HISTORY_KEYFRAME_INTERVAL == 0) {
+        node->keyframe = (BoardKeyframe*)malloc(sizeof(BoardKeyframe));
+        if (!node->keyframe) {
+            free(node);
+            return NULL;
+        }
+        memcpy(node->keyframe->board, board->board, sizeof(board->board));
+        node->keyframe->blackCaptures = board->blackCaptures;
+        node->keyframe->whiteCaptures = board->whiteCaptures;
+    }
     
     return node;
 }
 
+/**
+ * @brief 释放历史记录节点
+ */
+static void freeHistoryNode(BoardHistory* node) {
+    free(node->keyframe);
+    free(node);
+}
+
+/**
+ * @brief 只在棋盘数组上重做一个节点记录的变化（跳转时连续重放，之后统一重建派生数据）
+ */
+static void replayHistoryDelta(Board* board, BoardHistory* node) {
+    Stone color = (Stone)node->color;
+    
+    board->board[node->move] = (uint8_t)color;
+    for (int i = 0; i < node->capturedCount; i++) {
+        board->board[node->captured[i]] = EMPTY;
+    }
+    
+    if (color == BLACK) {
+        board->blackCaptures += node->capturedCount;
+    } else {
+        board->whiteCaptures += node->capturedCount;
+    }
+}
+
+/**
+ * @brief 重做或撤销一个节点记录的变化，只更新落子点和被提棋子周围的棋子组
+ * @param board 棋盘
+ * @param node 历史记录节点
+ * @param undo true 表示撤销（拿走落子、放回被提的子），false 表示重做
+ */
+static void updateHistoryDelta(Board* board, BoardHistory* node, bool undo) {
+    Stone color = (Stone)node->color;
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    int vertices[BOARD_SIZE * BOARD_SIZE + 1];
+    uint8_t colors[BOARD_SIZE * BOARD_SIZE + 1];
+    
+    vertices[0] = node->move;
+    colors[0] = (uint8_t)(undo ? EMPTY : color);
+    for (int i = 0; i < node->capturedCount; i++) {
+        vertices[i + 1] = node->captured[i];
+        colors[i + 1] = (uint8_t)(undo ? opponentColor : EMPTY);
+    }
+    updateStones(board, vertices, colors, node->capturedCount + 1);
+    
+    int captures = undo ? -node->capturedCount : node->capturedCount;
+    if (color == BLACK) {
+        board->blackCaptures += captures;
+    } else {
+        board->whiteCaptures += captures;
+    }
+}
+
+/**
+ * @brief 棋盘更新到某个历史节点之后，同步其余状态
+ */
+static void restoreFromHistory(Board* board, BoardHistory* node) {
+    board->current = node;
+    board->lastMove = node->move;
+    board->hash = node->hash;
+    board->koActive = node->koActive;
+    board->koPosition = node->koPosition;
+    
+    // 头节点之后轮到黑方，其余为落子方的对手
+    board->currentPlayer = (node->color == BLACK) ? WHITE : BLACK;
+}
+
 void initBoard(Board* board) {
-    // 初始化棋盘为空
-    memset(board->board, EMPTY, sizeof(board->board));
+    // 初始化棋盘：四周为哨兵，内部为空
+    memset(board->board, OFFBOARD, sizeof(board->board));
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            board->board[VERTEX(x, y)] = EMPTY;
+        }
+    }
     
     // 设置初始玩家为黑方
     board->currentPlayer = BLACK;
     
     // 初始化其他属性
-    board->lastMove.x = -1;
-    board->lastMove.y = -1;
-    board->koPosition.x = -1;
-    board->koPosition.y = -1;
+    board->lastMove = NO_VERTEX;
+    board->koPosition = NO_VERTEX;
     board->koActive = false;
     board->blackCaptures = 0;
     board->whiteCaptures = 0;
     board->blackLiberties = 0;
     board->whiteLiberties = 0;
     
-    // 创建历史记录头节点
-    board->history = createHistoryNode(board);
+    // 清空后端的派生数据
+    rebuildBoardCache(board);
+    
+    // 初始化局面哈希，并记录空棋盘局面
+    initZobrist();
+    board->hash = EMPTY_BOARD_HASH;
+    board->seenPositions = NULL;
+    board->seenCapacity = 0;
+    board->seenCount = 0;
+    board->current = NULL;
+    addSeenPosition(board, board->hash);
+    
+    // 创建历史记录头节点（同时是第一个关键帧）
+    board->history = createHistoryNode(board, 0, NO_VERTEX, EMPTY, NULL, 0);
     board->current = board->history;
 }
 
@@ -65,278 +288,230 @@ void freeBoard(Board* board) {
     BoardHistory* current = board->history;
     while (current) {
         BoardHistory* next = current->next;
-        free(current);
+        freeHistoryNode(current);
         current = next;
     }
     
+    free(board->seenPositions);
+    
     // 重置指针
     board->history = NULL;
     board->current = NULL;
+    board->seenPositions = NULL;
+    board->seenCapacity = 0;
+    board->seenCount = 0;
 }
 
-/**
- * @brief 深度优先搜索标记连通的棋子组
- * @param board 棋盘
- * @param pos 起始位置
- * @param color 棋子颜色
- * @param visited 访问标记数组
- * @param group 棋子组数组（输出）
- * @param groupSize 棋子组大小（输出）
- */
-static void dfsMarkGroup(Board* board, Position pos, Stone color, bool visited[BOARD_SIZE][BOARD_SIZE], 
-                         Position group[], int* groupSize) {
-    // 标记当前位置为已访问
-    visited[pos.y][pos.x] = true;
-    
-    // 将当前位置加入棋子组
-    group[*groupSize] = pos;
-    (*groupSize)++;
-    
-    // 检查四个相邻位置
-    for (int i = 0; i < 4; i++) {
-        Position next = {pos.x + DX[i], pos.y + DY[i]};
-        
-        // 检查位置是否有效且未访问过
-        if (isValidPosition(next) && !visited[next.y][next.x] && 
-            board->board[next.y][next.x] == color) {
-            dfsMarkGroup(board, next, color, visited, group, groupSize);
-        }
-    }
-}
+#ifndef BOARD_BITBOARD
+// ---------------------------------------------------------------------------
+// 棋子组表后端：每个棋子记录所属组的代表点，代表点上记录组的棋子数和气数，
+// 落子时只检查四个相邻点，合并或提取涉及的棋子组
+// ---------------------------------------------------------------------------
 
-/**
- * @brief 计算棋子组的气数
- * @param board 棋盘
- * @param group 棋子组
- * @param groupSize 棋子组大小
- * @return 气数
- */
-static int calculateGroupLiberties(Board* board, Position group[], int groupSize) {
-    bool libertyVisited[BOARD_SIZE][BOARD_SIZE] = {false};
-    int liberties = 0;
-    
-    // 检查每个棋子的相邻位置
-    for (int i = 0; i < groupSize; i++) {
-        Position pos = group[i];
-        
-        // 检查四个相邻位置
-        for (int j = 0; j < 4; j++) {
-            Position next = {pos.x + DX[j], pos.y + DY[j]};
-            
-            // 如果相邻位置是空的且未计算过，则为一口气
-            if (isValidPosition(next) && board->board[next.y][next.x] == EMPTY && 
-                !libertyVisited[next.y][next.x]) {
-                libertyVisited[next.y][next.x] = true;
-                liberties++;
-            }
-        }
-    }
-    
-    return liberties;
+void rebuildBoardCache(Board* board) {
+    buildGroupTable(&board->groups, board->board);
 }
 
-bool hasLiberty(Board* board, Position pos) {
-    if (!isValidPosition(pos)) return false;
-    
-    Stone color = board->board[pos.y][pos.x];
-    if (color == EMPTY) return true;
+bool hasLiberty(Board* board, int vertex) {
+    if (!isValidVertex(board, vertex)) return false;
     
-    bool visited[BOARD_SIZE][BOARD_SIZE] = {false};
-    Position group[BOARD_SIZE * BOARD_SIZE];
-    int groupSize = 0;
+    if (board->board[vertex] == EMPTY) return true;
     
-    // 标记连通的棋子组
-    dfsMarkGroup(board, pos, color, visited, group, &groupSize);
-    
-    // 计算气数
-    return calculateGroupLiberties(board, group, groupSize) > 0;
+    return board->groups.groupLibs[board->groups.groupId[vertex]] > 0;
 }
 
-int countLiberties(Board* board, Position pos) {
-    if (!isValidPosition(pos)) return 0;
-    
-    Stone color = board->board[pos.y][pos.x];
-    if (color == EMPTY) return 0;
+int countLiberties(Board* board, int vertex) {
+    if (!isValidVertex(board, vertex)) return 0;
     
-    bool visited[BOARD_SIZE][BOARD_SIZE] = {false};
-    Position group[BOARD_SIZE * BOARD_SIZE];
-    int groupSize = 0;
+    if (board->board[vertex] == EMPTY) return 0;
     
-    // 标记连通的棋子组
-    dfsMarkGroup(board, pos, color, visited, group, &groupSize);
-    
-    // 计算气数
-    return calculateGroupLiberties(board, group, groupSize);
+    return board->groups.groupLibs[board->groups.groupId[vertex]];
 }
 
-int captureDeadStones(Board* board, Stone color) {
-    int capturedCount = 0;
-    bool visited[BOARD_SIZE][BOARD_SIZE] = {false};
-    
-    // 遍历整个棋盘
-    for (int y = 0; y < BOARD_SIZE; y++) {
-        for (int x = 0; x < BOARD_SIZE; x++) {
-            // 如果是指定颜色的棋子且未访问过
-            if (board->board[y][x] == color && !visited[y][x]) {
-                Position pos = {x, y};
-                Position group[BOARD_SIZE * BOARD_SIZE];
-                int groupSize = 0;
-                
-                // 标记连通的棋子组
-                dfsMarkGroup(board, pos, color, visited, group, &groupSize);
-                
-                // 如果没有气，则提子
-                if (calculateGroupLiberties(board, group, groupSize) == 0) {
-                    // 记录最后一个被提的子（用于打劫判断）
-                    if (groupSize == 1) {
-                        board->koPosition = group[0];
-                    } else {
-                        board->koPosition.x = -1;
-                        board->koPosition.y = -1;
-                    }
-                    
-                    // 提子
-                    for (int i = 0; i < groupSize; i++) {
-                        board->board[group[i].y][group[i].x] = EMPTY;
-                        capturedCount++;
-                    }
+/**
+ * @brief 累加给定格点及其相邻格点所属棋子组的气数（每个棋子组只计一次）
+ * @param board 棋盘
+ * @param vertices 格点列表
+ * @param count 格点数量
+ * @param totals 按棋子颜色累加的气数
+ */
+static void libertiesAround(Board* board, const int* vertices, int count, int totals[3]) {
+    int16_t seen[BOARD_VERTICES];
+    int seenCount = 0;
+    
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < 5; j++) {
+            int v = (j < 4) ? vertices[i] + NEIGHBOR_OFFSETS[j] : vertices[i];
+            int g = board->groups.groupId[v];
+            if (g == NO_VERTEX) continue;
+            
+            bool duplicate = false;
+            for (int k = 0; k < seenCount; k++) {
+                if (seen[k] == g) {
+                    duplicate = true;
+                    break;
                 }
             }
+            if (duplicate) continue;
+            
+            seen[seenCount++] = (int16_t)g;
+            totals[board->board[g]] += board->groups.groupLibs[g];
+        }
+    }
+}
+
+void updateStones(Board* board, const int* vertices, const uint8_t* colors, int count) {
+    int before[3] = {0, 0, 0};
+    libertiesAround(board, vertices, count, before);
+    
+    // 拆掉包含这些格点或与它们相邻的棋子组
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < 5; j++) {
+            int head = board->groups.groupId[(j < 4) ? vertices[i] + NEIGHBOR_OFFSETS[j] : vertices[i]];
+            if (head == NO_VERTEX) continue;
+            
+            int v = head;
+            do {
+                board->groups.groupId[v] = NO_VERTEX;
+                v = board->groups.nextStone[v];
+            } while (v != head);
         }
     }
     
-    // 更新提子数
-    if (color == BLACK) {
-        board->whiteCaptures += capturedCount;
-    } else if (color == WHITE) {
-        board->blackCaptures += capturedCount;
+    for (int i = 0; i < count; i++) {
+        board->board[vertices[i]] = colors[i];
     }
     
-    return capturedCount;
-}
-
-bool isKoMove(Board* board, Position pos) {
-    // 如果打劫标志未激活，则不是打劫
-    if (!board->koActive) return false;
+    // 拆掉的组剩下的棋子和新放上的棋子都在这些格点上或与它们相邻，从这里重新建组
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < 5; j++) {
+            int v = (j < 4) ? vertices[i] + NEIGHBOR_OFFSETS[j] : vertices[i];
+            Stone color = (Stone)board->board[v];
+            if ((color == BLACK || color == WHITE) && board->groups.groupId[v] == NO_VERTEX) {
+                buildGroup(&board->groups, board->board, v);
+            }
+        }
+    }
     
-    // 检查是否是打劫位置
-    return pos.x == board->koPosition.x && pos.y == board->koPosition.y;
+    // 按前后差值更新双方气数
+    int after[3] = {0, 0, 0};
+    libertiesAround(board, vertices, count, after);
+    board->blackLiberties += after[BLACK] - before[BLACK];
+    board->whiteLiberties += after[WHITE] - before[WHITE];
 }
 
-bool isSuicideMove(Board* board, Position pos) {
-    if (!isValidPosition(pos) || board->board[pos.y][pos.x] != EMPTY) {
+bool isSuicideMove(Board* board, int vertex) {
+    if (!isValidVertex(board, vertex) || board->board[vertex] != EMPTY) {
         return false;
     }
     
-    // 临时放置棋子
-    Stone originalColor = board->board[pos.y][pos.x];
-    board->board[pos.y][pos.x] = board->currentPlayer;
-    
-    // 检查是否有气
-    bool hasLib = hasLiberty(board, pos);
-    
-    // 恢复原状
-    board->board[pos.y][pos.x] = originalColor;
-    
-    // 如果没有气，则是自杀行为
-    return !hasLib;
+    return isGroupSuicide(&board->groups, board->board, vertex, board->currentPlayer);
 }
 
-bool isValidMove(Board* board, Position pos) {
-    // 检查位置是否在棋盘范围内
-    if (!isValidPosition(pos)) return false;
+uint64_t hashAfterMove(Board* board, int vertex, Stone color) {
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    uint64_t hash = board->hash ^ zobristKeys[color][vertex];
     
-    // 检查位置是否为空
-    if (board->board[pos.y][pos.x] != EMPTY) return false;
-    
-    // 检查是否是打劫
-    if (isKoMove(board, pos)) return false;
-    
-    // 检查是否是自杀行为
-    if (isSuicideMove(board, pos)) return false;
+    // 只剩落子点这一口气的对方棋子组会被提掉
+    int seen[4];
+    int seenCount = 0;
+    for (int i = 0; i < 4; i++) {
+        int next = vertex + NEIGHBOR_OFFSETS[i];
+        if (board->board[next] != opponentColor) continue;
+        
+        int g = board->groups.groupId[next];
+        if (board->groups.groupLibs[g] != 1) continue;
+        
+        bool duplicate = false;
+        for (int j = 0; j < seenCount; j++) {
+            if (seen[j] == g) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) continue;
+        seen[seenCount++] = g;
+        
+        int v = g;
+        do {
+            hash ^= zobristKeys[opponentColor][v];
+            v = board->groups.nextStone[v];
+        } while (v != g);
+    }
     
-    return true;
+    return hash;
 }
 
-bool placeStone(Board* board, Position pos) {
-    // 检查落子是否合法
-    if (!isValidMove(board, pos)) return false;
-    
-    // 放置棋子
-    board->board[pos.y][pos.x] = board->currentPlayer;
-    
-    // 记录最后一步落子位置
-    board->lastMove = pos;
+int playStoneAndCapture(Board* board, int vertex, Stone color, int16_t* captured) {
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
     
-    // 重置打劫标志和位置
-    board->koActive = false;
-    board->koPosition.x = -1;
-    board->koPosition.y = -1;
+    // 气数只在落子点和将被提取的棋子周围变化：记下这些点，落子前后各累加一次周围棋子组的气数
+    int changed[BOARD_SIZE * BOARD_SIZE];
+    int changedCount = 0;
+    changed[changedCount++] = vertex;
     
-    // 提取对方无气的棋子（可能需要多次检查）
-    Stone opponentColor = (board->currentPlayer == BLACK) ? WHITE : BLACK;
-    int totalCaptured = 0;
-    int capturedCount;
-    
-    do {
-        capturedCount = captureDeadStones(board, opponentColor);
-        totalCaptured += capturedCount;
-    } while (capturedCount > 0);
-    
-    // 如果提了一个子，可能是打劫
-    if (totalCaptured == 1) {
-        // 检查落子后是否只有一个棋子且只有一口气
-        bool visited[BOARD_SIZE][BOARD_SIZE] = {false};
-        Position group[BOARD_SIZE * BOARD_SIZE];
-        int groupSize = 0;
-        
-        dfsMarkGroup(board, pos, board->currentPlayer, visited, group, &groupSize);
+    for (int i = 0; i < 4; i++) {
+        int g = board->groups.groupId[vertex + NEIGHBOR_OFFSETS[i]];
+        if (g == NO_VERTEX || board->board[g] != opponentColor || board->groups.groupLibs[g] != 1) continue;
         
-        if (groupSize == 1 && calculateGroupLiberties(board, group, groupSize) == 1) {
-            board->koActive = true;
+        // 只剩落子点这一口气的对方棋子组（同一组从多个方向相邻时只记一次）
+        bool duplicate = false;
+        for (int j = 1; j < changedCount; j++) {
+            if (board->groups.groupId[changed[j]] == g) {
+                duplicate = true;
+                break;
+            }
         }
+        if (duplicate) continue;
+        
+        int v = g;
+        do {
+            changed[changedCount++] = v;
+            v = board->groups.nextStone[v];
+        } while (v != g);
     }
     
-    // 计算双方气数
-    calculateLiberties(board);
+    int before[3] = {0, 0, 0};
+    libertiesAround(board, changed, changedCount, before);
     
-    // 保存当前棋盘状态到历史记录
-    saveBoardState(board);
+    // 放置棋子，提取无气的对方棋子组
+    board->hash ^= zobristKeys[color][vertex];
+    int dead[4];
+    int deadCount = placeGroupStone(&board->groups, board->board, vertex, color, dead);
     
-    // 切换玩家
-    board->currentPlayer = (board->currentPlayer == BLACK) ? WHITE : BLACK;
+    int totalCaptured = 0;
+    for (int i = 0; i < deadCount; i++) {
+        int v = dead[i];
+        do {
+            board->hash ^= zobristKeys[opponentColor][v];
+            captured[totalCaptured++] = (int16_t)v;
+            v = board->groups.nextStone[v];
+        } while (v != dead[i]);
+        
+        removeGroupStones(&board->groups, board->board, dead[i]);
+    }
     
-    return true;
+    // 按前后差值更新双方气数
+    int after[3] = {0, 0, 0};
+    libertiesAround(board, changed, changedCount, after);
+    board->blackLiberties += after[BLACK] - before[BLACK];
+    board->whiteLiberties += after[WHITE] - before[WHITE];
+    
+    return totalCaptured;
 }
 
 void calculateLiberties(Board* board) {
     board->blackLiberties = 0;
     board->whiteLiberties = 0;
     
-    bool visited[BOARD_SIZE][BOARD_SIZE] = {false};
-    
-    // 遍历整个棋盘
-    for (int y = 0; y < BOARD_SIZE; y++) {
-        for (int x = 0; x < BOARD_SIZE; x++) {
-            // 如果是棋子且未访问过
-            if ((board->board[y][x] == BLACK || board->board[y][x] == WHITE) && !visited[y][x]) {
-                Position pos = {x, y};
-                Position group[BOARD_SIZE * BOARD_SIZE];
-                int groupSize = 0;
-                
-                // 标记连通的棋子组
-                dfsMarkGroup(board, pos, board->board[y][x], visited, group, &groupSize);
-                
-                // 计算气数
-                int liberties = calculateGroupLiberties(board, group, groupSize);
-                
-                // 更新对应颜色的总气数
-                if (board->board[y][x] == BLACK) {
-                    board->blackLiberties += liberties;
-                } else if (board->board[y][x] == WHITE) {
-                    board->whiteLiberties += liberties;
-                }
-            }
+    // 累加每个棋子组代表点上记录的气数（空位和边界的 groupId 是 NO_VERTEX，格点 0 不是代表点）
+    for (int v = 0; v < BOARD_VERTICES; v++) {
+        if (v == NO_VERTEX || board->groups.groupId[v] != v) continue;
+        
+        if (board->board[v] == BLACK) {
+            board->blackLiberties += board->groups.groupLibs[v];
+        } else {
+            board->whiteLiberties += board->groups.groupLibs[v];
         }
     }
 }
@@ -347,83 +522,68 @@ int determineWinner(Board* board) {
     int whitePoints = 0;
     
     // 标记数组，用于记录已检查过的空地
-    bool visited[BOARD_SIZE][BOARD_SIZE] = {false};
+    bool visited[BOARD_VERTICES] = {false};
     
     // 第一步：统计双方直接占据的交叉点
-    for (int y = 0; y < BOARD_SIZE; y++) {
-        for (int x = 0; x < BOARD_SIZE; x++) {
-            if (board->board[y][x] == BLACK) {
-                blackPoints++;
-            } else if (board->board[y][x] == WHITE) {
-                whitePoints++;
-            }
+    for (int v = 0; v < BOARD_VERTICES; v++) {
+        if (board->board[v] == BLACK) {
+            blackPoints++;
+        } else if (board->board[v] == WHITE) {
+            whitePoints++;
         }
     }
     
     // 第二步：计算空地的归属（确定地盘）
-    for (int y = 0; y < BOARD_SIZE; y++) {
-        for (int x = 0; x < BOARD_SIZE; x++) {
-            // 如果是空地且未访问过
-            if (board->board[y][x] == EMPTY && !visited[y][x]) {
-                // 找出与该空地相连的所有空地
-                int territorySize = 0;
-                bool touchesBlack = false;
-                bool touchesWhite = false;
-                
-                // DFS查找连通的空地
-                Position queue[BOARD_SIZE * BOARD_SIZE];
-                int front = 0, rear = 0;
-                
-                // 添加初始点
-                Position startPos = {x, y};
-                queue[rear++] = startPos;
-                visited[y][x] = true;
-                territorySize++;
+    for (int v = 0; v < BOARD_VERTICES; v++) {
+        // 如果是空地且未访问过
+        if (board->board[v] == EMPTY && !visited[v]) {
+            // 找出与该空地相连的所有空地
+            int territorySize = 0;
+            bool touchesBlack = false;
+            bool touchesWhite = false;
+            
+            // BFS查找连通的空地
+            int queue[BOARD_SIZE * BOARD_SIZE];
+            int front = 0, rear = 0;
+            
+            // 添加初始点
+            queue[rear++] = v;
+            visited[v] = true;
+            territorySize++;
+            
+            // BFS遍历
+            while (front < rear) {
+                int current = queue[front++];
                 
-                // BFS遍历
-                while (front < rear) {
-                    Position current = queue[front++];
+                // 检查四个方向（哨兵边界自然被跳过）
+                for (int d = 0; d < 4; d++) {
+                    int next = current + NEIGHBOR_OFFSETS[d];
                     
-                    // 检查四个方向
-                    for (int d = 0; d < 4; d++) {
-                        int dx[4] = {-1, 0, 1, 0};
-                        int dy[4] = {0, -1, 0, 1};
-                        
-                        int nx = current.x + dx[d];
-                        int ny = current.y + dy[d];
-                        
-                        // 检查边界
-                        if (nx < 0 || nx >= BOARD_SIZE || ny < 0 || ny >= BOARD_SIZE) {
-                            continue;
-                        }
-                        
-                        // 如果是空地且未访问过
-                        if (board->board[ny][nx] == EMPTY && !visited[ny][nx]) {
-                            Position nextPos = {nx, ny};
-                            queue[rear++] = nextPos;
-                            visited[ny][nx] = true;
-                            territorySize++;
-                        }
-                        // 检查是否接触到黑子或白子
-                        else if (board->board[ny][nx] == BLACK) {
-                            touchesBlack = true;
-                        }
-                        else if (board->board[ny][nx] == WHITE) {
-                            touchesWhite = true;
-                        }
+                    // 如果是空地且未访问过
+                    if (board->board[next] == EMPTY && !visited[next]) {
+                        queue[rear++] = next;
+                        visited[next] = true;
+                        territorySize++;
+                    }
+                    // 检查是否接触到黑子或白子
+                    else if (board->board[next] == BLACK) {
+                        touchesBlack = true;
+                    }
+                    else if (board->board[next] == WHITE) {
+                        touchesWhite = true;
                     }
                 }
-                
-                // 判断空地归属
-                if (touchesBlack && !touchesWhite) {
-                    // 空地只与黑子相邻，归黑方
-                    blackPoints += territorySize;
-                } else if (!touchesBlack && touchesWhite) {
-                    // 空地只与白子相邻，归白方
-                    whitePoints += territorySize;
-                }
-                // 如果与双方都相邻或都不相邻，则为中立点，不计分
             }
+            
+            // 判断空地归属
+            if (touchesBlack && !touchesWhite) {
+                // 空地只与黑子相邻，归黑方
+                blackPoints += territorySize;
+            } else if (!touchesBlack && touchesWhite) {
+                // 空地只与白子相邻，归白方
+                whitePoints += territorySize;
+            }
+            // 如果与双方都相邻或都不相邻，则为中立点，不计分
         }
     }
     
@@ -431,22 +591,109 @@ int determineWinner(Board* board) {
     blackPoints += board->whiteCaptures;
     whitePoints += board->blackCaptures;
     
-    // 第四步：加上贴目（白棋有3.75目的贴目优势，简化为4目）
-    whitePoints += 4;  // 贴目（中国规则通常为3.75，简化为4）
+    // 第四步：白方加上贴目（半目贴目不会出现和棋）
+    double whiteScore = whitePoints + KOMI;
     
     // 确定胜者
-    if (blackPoints > whitePoints) {
+    if (blackPoints > whiteScore) {
         return BLACK;  // 黑胜
-    } else if (whitePoints > blackPoints) {
+    } else if (whiteScore > blackPoints) {
         return WHITE;  // 白胜
     } else {
         return 0;      // 平局（实际围棋很少出现平局）
     }
 }
 
-void saveBoardState(Board* board) {
+#endif // BOARD_BITBOARD
+
+bool isKoMove(Board* board, int vertex) {
+    // 如果打劫标志未激活，则不是打劫
+    if (!board->koActive) return false;
+    
+    // 检查是否是打劫位置
+    return vertex == board->koPosition;
+}
+
+bool isValidMove(Board* board, int vertex) {
+    // 检查格点是否在棋盘范围内
+    if (!isValidVertex(board, vertex)) return false;
+    
+    // 检查位置是否为空
+    if (board->board[vertex] != EMPTY) return false;
+    
+    // 检查是否是打劫
+    if (isKoMove(board, vertex)) return false;
+    
+    // 检查是否是自杀行为
+    if (isSuicideMove(board, vertex)) return false;
+    
+    // 检查是否重复以前的局面
+    if (isSuperkoMove(board, vertex)) return false;
+    
+    return true;
+}
+
+bool isSuperkoMove(Board* board, int vertex) {
+    return positionSeen(board, hashAfterMove(board, vertex, board->currentPlayer));
+}
+
+bool placeStone(Board* board, int vertex) {
+    // 检查落子是否合法
+    if (!isValidMove(board, vertex)) return false;
+    
+    Stone color = board->currentPlayer;
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    
+    // 记录最后一步落子位置
+    board->lastMove = vertex;
+    
+    // 重置打劫标志和位置
+    board->koActive = false;
+    board->koPosition = NO_VERTEX;
+    
+    // 放置棋子并提取对方无气的棋子
+    int16_t captured[BOARD_SIZE * BOARD_SIZE];
+    int totalCaptured = playStoneAndCapture(board, vertex, color, captured);
+    
+    // 更新提子数
+    if (color == BLACK) {
+        board->blackCaptures += totalCaptured;
+    } else {
+        board->whiteCaptures += totalCaptured;
+    }
+    
+    // 如果提了一个子，且落子后是只有一口气的孤子，则是打劫
+    if (totalCaptured == 1 && countLiberties(board, vertex) == 1) {
+        bool isolated = true;
+        for (int i = 0; i < 4; i++) {
+            if (board->board[vertex + NEIGHBOR_OFFSETS[i]] == color) {
+                isolated = false;
+                break;
+            }
+        }
+        
+        if (isolated) {
+            board->koActive = true;
+            board->koPosition = captured[0];
+        }
+    }
+    
+    // 记录新局面，用于全局同形判断
+    addSeenPosition(board, board->hash);
+    
+    // 保存当前棋盘状态到历史记录
+    saveBoardState(board, vertex, captured, totalCaptured);
+    
+    // 切换玩家
+    board->currentPlayer = opponentColor;
+    
+    return true;
+}
+
+void saveBoardState(Board* board, int vertex, const int16_t* captured, int capturedCount) {
     // 创建新的历史记录节点
-    BoardHistory* newNode = createHistoryNode(board);
+    BoardHistory* newNode = createHistoryNode(board, board->current->moveNumber + 1, vertex,
+                                              board->currentPlayer, captured, capturedCount);
     if (!newNode) return;
     
     // 如果当前节点不是链表尾，则删除后续节点
@@ -454,7 +701,7 @@ void saveBoardState(Board* board) {
     while (next) {
         BoardHistory* temp = next;
         next = next->next;
-        free(temp);
+        freeHistoryNode(temp);
     }
     
     // 连接新节点
@@ -472,24 +719,12 @@ bool undoMove(Board* board) {
         return false;
     }
     
-    // 移动到前一个历史记录节点
-    board->current = board->current->prev;
-    
-    // 恢复棋盘状态
-    memcpy(board->board, board->current->board, sizeof(board->board));
-    board->lastMove = board->current->lastMove;
-    board->blackCaptures = board->current->blackCaptures;
-    board->whiteCaptures = board->current->whiteCaptures;
-    board->blackLiberties = board->current->blackLiberties;
-    board->whiteLiberties = board->current->whiteLiberties;
-    
-    // 切换玩家
-    board->currentPlayer = (board->currentPlayer == BLACK) ? WHITE : BLACK;
+    // 当前局面不再属于棋局路线
+    removeSeenPosition(board, board->hash);
     
-    // 重置打劫标志
-    board->koActive = false;
-    board->koPosition.x = -1;
-    board->koPosition.y = -1;
+    // 撤销当前节点的变化，回到前一个节点
+    updateHistoryDelta(board, board->current, true);
+    restoreFromHistory(board, board->current->prev);
     
     return true;
 }
@@ -500,24 +735,46 @@ bool redoMove(Board* board) {
         return false;
     }
     
-    // 移动到后一个历史记录节点
-    board->current = board->current->next;
+    // 重做后一个节点的变化
+    updateHistoryDelta(board, board->current->next, false);
+    restoreFromHistory(board, board->current->next);
+    addSeenPosition(board, board->hash);
     
-    // 恢复棋盘状态
-    memcpy(board->board, board->current->board, sizeof(board->board));
-    board->lastMove = board->current->lastMove;
-    board->blackCaptures = board->current->blackCaptures;
-    board->whiteCaptures = board->current->whiteCaptures;
-    board->blackLiberties = board->current->blackLiberties;
-    board->whiteLiberties = board->current->whiteLiberties;
-    
-    // 切换玩家
-    board->currentPlayer = (board->currentPlayer == BLACK) ? WHITE : BLACK;
+    return true;
+}
+
+bool gotoMove(Board* board, int moveNumber) {
+    if (!board->current) return false;
+    
+    // 沿链表找到目标节点
+    BoardHistory* target = board->current;
+    while (target && target->moveNumber > moveNumber) target = target->prev;
+    while (target && target->moveNumber < moveNumber) target = target->next;
+    if (!target || target->moveNumber != moveNumber) return false;
+    
+    // 从不晚于目标的最近关键帧开始重放
+    BoardHistory* node = target;
+    while (!node->keyframe) node = node->prev;
+    
+    memcpy(board->board, node->keyframe->board, sizeof(board->board));
+    board->blackCaptures = node->keyframe->blackCaptures;
+    board->whiteCaptures = node->keyframe->whiteCaptures;
+    while (node != target) {
+        node = node->next;
+        replayHistoryDelta(board, node);
+    }
+    restoreFromHistory(board, target);
+    rebuildBoardCache(board);
+    calculateLiberties(board);
     
-    // 重置打劫标志
-    board->koActive = false;
-    board->koPosition.x = -1;
-    board->koPosition.y = -1;
+    // 重建棋局路线上的局面集合
+    if (board->seenCapacity > 0) {
+        memset(board->seenPositions, 0, board->seenCapacity * sizeof(uint64_t));
+    }
+    board->seenCount = 0;
+    for (node = board->history; node != target->next; node = node->next) {
+        addSeenPosition(board, node->hash);
+    }
     
     return true;
 }
\ No newline at end of file
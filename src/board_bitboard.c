@@ -0,0 +1,339 @@
+/**
+ * @file board_bitboard.c
+ * @brief 位棋盘后端：棋子组、气、提子和地盘都通过按位膨胀计算
+ *
+ * 使用 make BOARD_BACKEND=bitboard 编译时替换 board.c 中的棋子组表后端。
+ */
+
+#include "../include/board.h"
+
+#ifdef BOARD_BITBOARD
+
+/**
+ * @brief 检查格点是否在棋盘范围内
+ */
+static bool isValidVertex(Board* board, int vertex) {
+    return vertex > 0 && vertex < BOARD_VERTICES && board->board[vertex] != OFFBOARD;
+}
+
+/**
+ * @brief 计算当前的空位集合
+ */
+static void emptyPoints(Board* board, Bitboard* out) {
+    Bitboard occupied;
+    bbOr(&board->stones[BLACK], &board->stones[WHITE], &occupied);
+    bbAndNot(bbOnBoard(), &occupied, out);
+}
+
+/**
+ * @brief 提取包含指定格点的棋子组
+ */
+static void groupAt(Board* board, int vertex, Bitboard* group) {
+    Bitboard seed;
+    bbClear(&seed);
+    bbSetBit(&seed, vertex);
+    bbFloodFill(&seed, &board->stones[board->board[vertex]], group);
+}
+
+/**
+ * @brief 计算棋子组在给定空位集合中的气数
+ */
+static int groupLiberties(const Bitboard* group, const Bitboard* empty) {
+    Bitboard liberties;
+    bbNeighbors(group, &liberties);
+    bbAnd(&liberties, empty, &liberties);
+    return bbPopCount(&liberties);
+}
+
+/**
+ * @brief 从棋盘上移除一组棋子
+ * @param removedOut 被移除棋子的格点（输出）
+ * @return 移除的棋子数量
+ */
+static int removeStones(Board* board, const Bitboard* group, Stone color, int16_t* removedOut) {
+    bbAndNot(&board->stones[color], group, &board->stones[color]);
+    
+    int removed = 0;
+    for (int i = 0; i < BITBOARD_WORDS; i++) {
+        uint64_t bits = group->w[i];
+        while (bits) {
+            int v = i * 64 + __builtin_ctzll(bits);
+            board->board[v] = EMPTY;
+            board->hash ^= zobristKeys[color][v];
+            bits &= bits - 1;
+            removedOut[removed++] = (int16_t)v;
+        }
+    }
+    
+    return removed;
+}
+
+/**
+ * @brief 累加与给定格点集合相交或相邻的棋子组的气数
+ * @param board 棋盘
+ * @param points 格点集合
+ * @param totals 按棋子颜色累加的气数
+ */
+static void libertiesAround(Board* board, const Bitboard* points, int totals[3]) {
+    Bitboard region, empty;
+    bbNeighbors(points, &region);
+    bbOr(&region, points, &region);
+    emptyPoints(board, &empty);
+    
+    for (int color = BLACK; color <= WHITE; color++) {
+        Bitboard remaining;
+        bbAnd(&board->stones[color], &region, &remaining);
+        
+        while (!bbIsZero(&remaining)) {
+            Bitboard group;
+            groupAt(board, bbFirstBit(&remaining), &group);
+            bbAndNot(&remaining, &group, &remaining);
+            totals[color] += groupLiberties(&group, &empty);
+        }
+    }
+}
+
+void rebuildBoardCache(Board* board) {
+    initBitboardTables();
+    
+    bbClear(&board->stones[EMPTY]);
+    bbClear(&board->stones[BLACK]);
+    bbClear(&board->stones[WHITE]);
+    
+    for (int v = 0; v < BOARD_VERTICES; v++) {
+        if (board->board[v] == BLACK || board->board[v] == WHITE) {
+            bbSetBit(&board->stones[board->board[v]], v);
+        }
+    }
+}
+
+void updateStones(Board* board, const int* vertices, const uint8_t* colors, int count) {
+    Bitboard changed;
+    bbClear(&changed);
+    for (int i = 0; i < count; i++) {
+        bbSetBit(&changed, vertices[i]);
+    }
+    
+    // 气数只在这些格点周围的棋子组上变化，按前后差值更新
+    int before[3] = {0, 0, 0};
+    libertiesAround(board, &changed, before);
+    
+    for (int i = 0; i < count; i++) {
+        int v = vertices[i];
+        Stone old = (Stone)board->board[v];
+        if (old == BLACK || old == WHITE) bbClearBit(&board->stones[old], v);
+        
+        board->board[v] = colors[i];
+        if (colors[i] == BLACK || colors[i] == WHITE) bbSetBit(&board->stones[colors[i]], v);
+    }
+    
+    int after[3] = {0, 0, 0};
+    libertiesAround(board, &changed, after);
+    board->blackLiberties += after[BLACK] - before[BLACK];
+    board->whiteLiberties += after[WHITE] - before[WHITE];
+}
+
+bool hasLiberty(Board* board, int vertex) {
+    if (!isValidVertex(board, vertex)) return false;
+    
+    if (board->board[vertex] == EMPTY) return true;
+    
+    return countLiberties(board, vertex) > 0;
+}
+
+int countLiberties(Board* board, int vertex) {
+    if (!isValidVertex(board, vertex)) return 0;
+    
+    if (board->board[vertex] == EMPTY) return 0;
+    
+    Bitboard group, empty;
+    groupAt(board, vertex, &group);
+    emptyPoints(board, &empty);
+    
+    return groupLiberties(&group, &empty);
+}
+
+bool isSuicideMove(Board* board, int vertex) {
+    if (!isValidVertex(board, vertex) || board->board[vertex] != EMPTY) {
+        return false;
+    }
+    
+    Stone color = board->currentPlayer;
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    
+    // 相邻有空位，落子后必然有气
+    for (int i = 0; i < 4; i++) {
+        if (board->board[vertex + NEIGHBOR_OFFSETS[i]] == EMPTY) return false;
+    }
+    
+    // 落子后的空位集合
+    Bitboard empty;
+    emptyPoints(board, &empty);
+    bbClearBit(&empty, vertex);
+    
+    // 落子后己方棋子组仍有气
+    Bitboard own, seed, group;
+    own = board->stones[color];
+    bbSetBit(&own, vertex);
+    bbClear(&seed);
+    bbSetBit(&seed, vertex);
+    bbFloodFill(&seed, &own, &group);
+    if (groupLiberties(&group, &empty) > 0) return false;
+    
+    // 能提取对方棋子组
+    for (int i = 0; i < 4; i++) {
+        int next = vertex + NEIGHBOR_OFFSETS[i];
+        if (board->board[next] != opponentColor) continue;
+        
+        groupAt(board, next, &group);
+        if (groupLiberties(&group, &empty) == 0) return false;
+    }
+    
+    // 如果没有气，则是自杀行为
+    return true;
+}
+
+uint64_t hashAfterMove(Board* board, int vertex, Stone color) {
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    uint64_t hash = board->hash ^ zobristKeys[color][vertex];
+    
+    // 落子后的空位集合
+    Bitboard empty, checked;
+    emptyPoints(board, &empty);
+    bbClearBit(&empty, vertex);
+    bbClear(&checked);
+    
+    // 落子后没有气的对方棋子组会被提掉
+    for (int i = 0; i < 4; i++) {
+        int next = vertex + NEIGHBOR_OFFSETS[i];
+        if (board->board[next] != opponentColor || bbTestBit(&checked, next)) continue;
+        
+        Bitboard group;
+        groupAt(board, next, &group);
+        bbOr(&checked, &group, &checked);
+        if (groupLiberties(&group, &empty) > 0) continue;
+        
+        for (int w = 0; w < BITBOARD_WORDS; w++) {
+            uint64_t bits = group.w[w];
+            while (bits) {
+                hash ^= zobristKeys[opponentColor][w * 64 + __builtin_ctzll(bits)];
+                bits &= bits - 1;
+            }
+        }
+    }
+    
+    return hash;
+}
+
+int playStoneAndCapture(Board* board, int vertex, Stone color, int16_t* captured) {
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    
+    Bitboard empty, checked, dead;
+    emptyPoints(board, &empty);
+    bbClear(&checked);
+    bbClear(&dead);
+    
+    // 只剩落子点这一口气的相邻对方棋子组会被提取
+    for (int i = 0; i < 4; i++) {
+        int next = vertex + NEIGHBOR_OFFSETS[i];
+        if (board->board[next] != opponentColor || bbTestBit(&checked, next)) continue;
+        
+        Bitboard group;
+        groupAt(board, next, &group);
+        bbOr(&checked, &group, &checked);
+        
+        if (groupLiberties(&group, &empty) == 1) {
+            bbOr(&dead, &group, &dead);
+        }
+    }
+    
+    // 气数只在落子点和被提棋子周围变化，落子前后各累加一次
+    Bitboard changed = dead;
+    bbSetBit(&changed, vertex);
+    int before[3] = {0, 0, 0};
+    libertiesAround(board, &changed, before);
+    
+    // 放置棋子并提子
+    board->board[vertex] = (uint8_t)color;
+    board->hash ^= zobristKeys[color][vertex];
+    bbSetBit(&board->stones[color], vertex);
+    int totalCaptured = removeStones(board, &dead, opponentColor, captured);
+    
+    // 按前后差值更新双方气数
+    int after[3] = {0, 0, 0};
+    libertiesAround(board, &changed, after);
+    board->blackLiberties += after[BLACK] - before[BLACK];
+    board->whiteLiberties += after[WHITE] - before[WHITE];
+    
+    return totalCaptured;
+}
+
+void calculateLiberties(Board* board) {
+    board->blackLiberties = 0;
+    board->whiteLiberties = 0;
+    
+    Bitboard empty;
+    emptyPoints(board, &empty);
+    
+    // 逐个取出棋子组，累加各组的气数
+    for (int color = BLACK; color <= WHITE; color++) {
+        Bitboard remaining = board->stones[color];
+        int total = 0;
+        
+        while (!bbIsZero(&remaining)) {
+            Bitboard group;
+            groupAt(board, bbFirstBit(&remaining), &group);
+            bbAndNot(&remaining, &group, &remaining);
+            total += groupLiberties(&group, &empty);
+        }
+        
+        if (color == BLACK) {
+            board->blackLiberties = total;
+        } else {
+            board->whiteLiberties = total;
+        }
+    }
+}
+
+int determineWinner(Board* board) {
+    Bitboard empty;
+    emptyPoints(board, &empty);
+    
+    // 第一步：统计双方直接占据的交叉点
+    int blackPoints = bbPopCount(&board->stones[BLACK]);
+    int whitePoints = bbPopCount(&board->stones[WHITE]);
+    
+    // 第二步：从双方棋子出发穿过空地扩散，只被一方到达的空地归该方
+    Bitboard blackArea, whiteArea, blackReach, whiteReach;
+    bbOr(&board->stones[BLACK], &empty, &blackArea);
+    bbOr(&board->stones[WHITE], &empty, &whiteArea);
+    bbFloodFill(&board->stones[BLACK], &blackArea, &blackReach);
+    bbFloodFill(&board->stones[WHITE], &whiteArea, &whiteReach);
+    
+    Bitboard blackTerritory, whiteTerritory;
+    bbAnd(&blackReach, &empty, &blackTerritory);
+    bbAndNot(&blackTerritory, &whiteReach, &blackTerritory);
+    bbAnd(&whiteReach, &empty, &whiteTerritory);
+    bbAndNot(&whiteTerritory, &blackReach, &whiteTerritory);
+    
+    blackPoints += bbPopCount(&blackTerritory);
+    whitePoints += bbPopCount(&whiteTerritory);
+    
+    // 第三步：加上提子数
+    blackPoints += board->whiteCaptures;
+    whitePoints += board->blackCaptures;
+    
+    // 第四步：白方加上贴目（与棋子组表后端一致）
+    double whiteScore = whitePoints + KOMI;
+    
+    // 确定胜者
+    if (blackPoints > whiteScore) {
+        return BLACK;  // 黑胜
+    } else if (whiteScore > blackPoints) {
+        return WHITE;  // 白胜
+    } else {
+        return 0;      // 平局
+    }
+}
+
+#endif // BOARD_BITBOARD
\ No newline at end of file
@@ -0,0 +1,167 @@
+/**
+ * @file engine.c
+ * @brief AI引擎线程实现
+ */
+
+#include "../include/engine.h"
+#include <limits.h>
+
+/**
+ * @brief 引擎线程：等待请求，执行搜索，完成后通知主线程
+ */
+static int engineThread(void* data) {
+    Engine* engine = (Engine*)data;
+    
+    SDL_LockMutex(engine->mutex);
+    while (true) {
+        while (engine->request == ENGINE_TASK_NONE) {
+            SDL_CondWait(engine->cond, engine->mutex);
+        }
+        if (engine->request == ENGINE_TASK_QUIT) break;
+        
+        // 取出请求
+        EngineTask task = engine->request;
+        int id = engine->requestId;
+        engine->request = ENGINE_TASK_NONE;
+        engine->busy = true;
+        SDL_UnlockMutex(engine->mutex);
+        
+        // 搜索期间不持锁，主线程通过停止标志打断
+        SearchTree* tree = &engine->tree;
+        if (task == ENGINE_TASK_SEARCH) {
+            runMCTSIterations(&engine->rootBoard, &engine->config, &tree->arenas[tree->activeArena], tree->root,
+                              engine->config.simulationCount, engine->config.timeLimit,
+                              &engine->stop, &engine->playouts, NULL);
+        } else {
+            // 节点池用满后树不再生长，后台思考随之结束
+            runMCTSIterations(&engine->rootBoard, &engine->config, &tree->arenas[tree->activeArena], tree->root,
+                              INT_MAX, 0, &engine->stop, &engine->playouts, &engine->treeFull);
+        }
+        
+        SDL_LockMutex(engine->mutex);
+        engine->busy = false;
+        if (task == ENGINE_TASK_SEARCH && !SDL_AtomicGet(&engine->stop)) {
+            engine->finishedId = id;
+        }
+        SDL_CondBroadcast(engine->cond);
+    }
+    SDL_UnlockMutex(engine->mutex);
+    
+    return 0;
+}
+
+bool initEngine(Engine* engine) {
+    engine->request = ENGINE_TASK_NONE;
+    engine->requestId = 0;
+    engine->busy = false;
+    engine->finishedId = 0;
+    engine->task = ENGINE_TASK_NONE;
+    engine->taskMoveNumber = -1;
+    engine->taskHash = 0;
+    engine->nextId = 1;
+    SDL_AtomicSet(&engine->stop, 0);
+    SDL_AtomicSet(&engine->playouts, 0);
+    SDL_AtomicSet(&engine->treeFull, 0);
+    initAIConfig(&engine->config);
+    
+    bool ok = initSearchTree(&engine->tree, &engine->config);
+    
+    engine->mutex = SDL_CreateMutex();
+    engine->cond = SDL_CreateCond();
+    engine->thread = NULL;
+    if (engine->mutex && engine->cond) {
+        engine->thread = SDL_CreateThread(engineThread, "engine", engine);
+    }
+    
+    return ok && engine->thread != NULL;
+}
+
+void freeEngine(Engine* engine) {
+    if (engine->thread) {
+        engineStop(engine);
+        
+        SDL_LockMutex(engine->mutex);
+        engine->request = ENGINE_TASK_QUIT;
+        SDL_CondBroadcast(engine->cond);
+        SDL_UnlockMutex(engine->mutex);
+        
+        SDL_WaitThread(engine->thread, NULL);
+        engine->thread = NULL;
+    }
+    
+    if (engine->cond) SDL_DestroyCond(engine->cond);
+    if (engine->mutex) SDL_DestroyMutex(engine->mutex);
+    engine->cond = NULL;
+    engine->mutex = NULL;
+    
+    freeSearchTree(&engine->tree);
+}
+
+void engineStop(Engine* engine) {
+    if (!engine->thread) return;
+    
+    SDL_LockMutex(engine->mutex);
+    
+    // 丢弃还没开始的请求，并打断正在执行的任务
+    engine->request = ENGINE_TASK_NONE;
+    if (engine->busy) {
+        SDL_AtomicSet(&engine->stop, 1);
+        while (engine->busy) {
+            SDL_CondWait(engine->cond, engine->mutex);
+        }
+    }
+    SDL_AtomicSet(&engine->stop, 0);
+    
+    SDL_UnlockMutex(engine->mutex);
+    
+    engine->task = ENGINE_TASK_NONE;
+}
+
+int engineSubmit(Engine* engine, EngineTask task, Board* board, AIConfig* config) {
+    if (!engine->thread) return 0;
+    
+    engineStop(engine);
+    
+    // 引擎空闲，在主线程中把搜索树推进到当前局面
+    if (!advanceSearchTree(&engine->tree, board)) return 0;
+    
+    engine->task = task;
+    engine->taskMoveNumber = engine->tree.rootMoveNumber;
+    engine->taskHash = engine->tree.rootHash;
+    SDL_AtomicSet(&engine->playouts, 0);
+    SDL_AtomicSet(&engine->treeFull, 0);
+    
+    SDL_LockMutex(engine->mutex);
+    int id = engine->nextId++;
+    engine->requestId = id;
+    engine->config = *config;
+    initPlayoutBoard(&engine->rootBoard, board);
+    engine->request = task;
+    SDL_CondBroadcast(engine->cond);
+    SDL_UnlockMutex(engine->mutex);
+    
+    return id;
+}
+
+bool engineResultReady(Engine* engine, int id) {
+    if (!engine->thread) return false;
+    
+    SDL_LockMutex(engine->mutex);
+    bool ready = !engine->busy && engine->request == ENGINE_TASK_NONE && engine->finishedId == id;
+    SDL_UnlockMutex(engine->mutex);
+    
+    return ready;
+}
+
+bool engineTaskMatches(Engine* engine, EngineTask task, Board* board) {
+    return engine->task == task && board->current &&
+           engine->taskMoveNumber == board->current->moveNumber && engine->taskHash == board->hash;
+}
+
+int enginePlayouts(Engine* engine) {
+    return SDL_AtomicGet(&engine->playouts);
+}
+
+bool engineTreeFull(Engine* engine) {
+    return SDL_AtomicGet(&engine->treeFull) != 0;
+}
\ No newline at end of file
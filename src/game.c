@@ -4,13 +4,16 @@
  */
 
 #include "../include/game.h"
-#include "../include/ai.h"
 #include <string.h>
 
 void initGame(Game* game) {
     // 初始化棋盘
     initBoard(&game->board);
     
+    // 启动AI引擎
+    initEngine(&game->engine);
+    game->aiRequest = 0;
+    
     // 设置初始游戏模式和状态
     game->mode = MODE_PVP;
     game->state = STATE_PLAYING;
@@ -22,9 +25,12 @@ void initGame(Game* game) {
 void freeGame(Game* game) {
     // 释放棋盘资源
     freeBoard(&game->board);
+    
+    // 停止AI引擎
+    freeEngine(&game->engine);
 }
 
-bool handlePlayerMove(Game* game, Position pos) {
+bool handlePlayerMove(Game* game, int vertex) {
     // 如果游戏未在进行中，则不处理落子
     if (game->state != STATE_PLAYING) {
         return false;
@@ -36,7 +42,7 @@ bool handlePlayerMove(Game* game, Position pos) {
     }
     
     // 尝试落子
-    bool success = placeStone(&game->board, pos);
+    bool success = placeStone(&game->board, vertex);
     
     // 如果落子成功，检查游戏是否结束
     if (success) {
@@ -46,20 +52,63 @@ bool handlePlayerMove(Game* game, Position pos) {
     return success;
 }
 
-bool handleAIMove(Game* game) {
-    // 如果游戏未在进行中或不是AI的回合，则不处理
-    if (game->state != STATE_PLAYING || 
-        game->mode != MODE_PVE || 
-        game->board.currentPlayer != WHITE) {
-        return false;
+/**
+ * @brief 为当前玩家请求AI落子：开局直接落子，否则提交异步搜索
+ * @param game 游戏指针
+ * @return 是否已提交搜索或直接落子
+ */
+static bool requestAIMove(Game* game) {
+    AIConfig config;
+    initAIConfig(&config);
+    
+    // 开局直接选择天元或星位，不需要搜索
+    int openingMove = chooseOpeningMove(&game->board, &config);
+    if (openingMove != NO_VERTEX) {
+        engineStop(&game->engine);
+        
+        bool success = placeStone(&game->board, openingMove);
+        if (success) {
+            updateGame(game);
+        }
+        return success;
+    }
+    
+    // 提交搜索，结果在 updateAI 中落子
+    game->aiRequest = engineSubmit(&game->engine, ENGINE_TASK_SEARCH, &game->board, &config);
+    game->aiThinking = game->aiRequest != 0;
+    
+    return game->aiThinking;
+}
+
+/**
+ * @brief 搜索完成后落子；悔棋、前进、模式切换或游戏结束后的结果直接丢弃
+ * @param game 游戏指针
+ */
+static void commitAIMove(Game* game) {
+    if (!game->aiRequest || !engineResultReady(&game->engine, game->aiRequest)) {
+        return;
+    }
+    
+    game->aiRequest = 0;
+    game->aiThinking = false;
+    
+    // 局面已经不是提交搜索时的局面
+    if (game->state != STATE_PLAYING ||
+        !engineTaskMatches(&game->engine, ENGINE_TASK_SEARCH, &game->board)) {
+        return;
     }
     
-    // 初始化AI配置
     AIConfig config;
     initAIConfig(&config);
     
-    // 使用蒙特卡洛树搜索找到最佳落子位置
-    Position bestMove = findBestMove(&game->board, &config);
+    // 引擎已空闲，可以读取搜索树
+    int bestMove = pickSearchMove(&game->engine.tree, &game->board, &config);
+    
+    // 没有可下的位置时结束游戏，否则下一帧又会为同一局面提交搜索
+    if (bestMove == NO_VERTEX) {
+        endGameManually(game);
+        return;
+    }
     
     // 尝试落子
     bool success = placeStone(&game->board, bestMove);
@@ -68,11 +117,67 @@ bool handleAIMove(Game* game) {
     if (success) {
         updateGame(game);
     }
+}
+
+bool handleAIMove(Game* game) {
+    // 如果游戏未在进行中或不是AI的回合，则不处理
+    if (game->state != STATE_PLAYING || 
+        game->mode != MODE_PVE || 
+        game->board.currentPlayer != WHITE ||
+        game->aiThinking) {
+        return false;
+    }
     
-    return success;
+    return requestAIMove(game);
+}
+
+bool makeAIMoveForCurrentPlayer(Game* game) {
+    // 如果游戏未在进行中或AI正在思考，则不处理
+    if (game->state != STATE_PLAYING || game->aiThinking) {
+        return false;
+    }
+    
+    return requestAIMove(game);
+}
+
+void cancelAIMove(Game* game) {
+    engineStop(&game->engine);
+    game->aiRequest = 0;
+    game->aiThinking = false;
+}
+
+void updateAI(Game* game) {
+    // 提交已完成的搜索结果
+    commitAIMove(game);
+    
+    // 仍在等待搜索结果
+    if (game->aiRequest) {
+        return;
+    }
+    
+    if (game->mode != MODE_PVE || game->state != STATE_PLAYING) {
+        // 不需要AI时停止后台思考
+        if (game->engine.task == ENGINE_TASK_PONDER) {
+            engineStop(&game->engine);
+        }
+        return;
+    }
+    
+    if (game->board.currentPlayer == WHITE) {
+        // 轮到AI，在后台思考得到的树上继续搜索
+        handleAIMove(game);
+    } else if (!engineTaskMatches(&game->engine, ENGINE_TASK_PONDER, &game->board)) {
+        // 轮到玩家，在后台思考当前局面（悔棋后改为思考新的局面）
+        AIConfig config;
+        initAIConfig(&config);
+        engineSubmit(&game->engine, ENGINE_TASK_PONDER, &game->board, &config);
+    }
 }
 
 void toggleGameMode(Game* game) {
+    // 切换模式后不再采用进行中的AI搜索结果
+    cancelAIMove(game);
+    
     // 切换游戏模式
     game->mode = (game->mode == MODE_PVP) ? MODE_PVE : MODE_PVP;
 }
@@ -88,6 +193,9 @@ bool handleUndo(Game* game) {
         return false;
     }
     
+    // 悔棋后不再采用进行中的AI搜索结果
+    cancelAIMove(game);
+    
     // 尝试悔棋
     bool success = undoMove(&game->board);
     
@@ -105,6 +213,9 @@ bool handleRedo(Game* game) {
         return false;
     }
     
+    // 前进后不再采用进行中的AI搜索结果
+    cancelAIMove(game);
+    
     // 尝试前进
     bool success = redoMove(&game->board);
     
@@ -116,10 +227,38 @@ bool handleRedo(Game* game) {
     return success;
 }
 
-void updateGame(Game* game) {
-    // 计算双方气数
-    calculateLiberties(&game->board);
+bool handleGotoMove(Game* game, int moveNumber) {
+    // 如果游戏未在进行中，则不处理跳转
+    if (game->state != STATE_PLAYING) {
+        return false;
+    }
+    
+    // 跳转后不再采用进行中的AI搜索结果
+    cancelAIMove(game);
+    
+    // 超出历史记录的手数按开局或最后一手处理
+    BoardHistory* last = game->board.current;
+    while (last->next) {
+        last = last->next;
+    }
+    if (moveNumber < 0) {
+        moveNumber = 0;
+    }
+    if (moveNumber > last->moveNumber) {
+        moveNumber = last->moveNumber;
+    }
+    
+    bool success = gotoMove(&game->board, moveNumber);
     
+    // 如果是人机模式且跳转后轮到AI，则退回一步
+    if (success && game->mode == MODE_PVE && game->board.currentPlayer == WHITE) {
+        success = undoMove(&game->board);
+    }
+    
+    return success;
+}
+
+void updateGame(Game* game) {
     // 检查游戏是否结束
     // 游戏结束的条件：
     // 1. 棋盘上没有空位（或空位很少）
@@ -129,7 +268,7 @@ void updateGame(Game* game) {
     int emptyCount = 0;
     for (int y = 0; y < BOARD_SIZE; y++) {
         for (int x = 0; x < BOARD_SIZE; x++) {
-            if (game->board.board[y][x] == EMPTY) {
+            if (game->board.board[VERTEX(x, y)] == EMPTY) {
                 emptyCount++;
                 
                 // 如果空位太多，游戏还未结束
@@ -170,31 +309,36 @@ bool isGameOver(Game* game) {
     return game->state == STATE_GAMEOVER;
 }
 
-const char* getViolationHint(Game* game, Position pos) {
+const char* getViolationHint(Game* game, int vertex) {
     // 如果不显示提示，则返回NULL
     if (!game->showHints) {
         return NULL;
     }
     
     // 检查位置是否在棋盘范围内
-    if (pos.x < 0 || pos.x >= BOARD_SIZE || pos.y < 0 || pos.y >= BOARD_SIZE) {
+    if (vertex <= NO_VERTEX || vertex >= BOARD_VERTICES || game->board.board[vertex] == OFFBOARD) {
         return "违规行为：位置超出棋盘范围";
     }
     
     // 检查位置是否已有棋子
-    if (game->board.board[pos.y][pos.x] != EMPTY) {
+    if (game->board.board[vertex] != EMPTY) {
         return "违规行为：该位置已有棋子";
     }
     
     // 检查是否是打劫
-    if (isKoMove(&game->board, pos)) {
+    if (isKoMove(&game->board, vertex)) {
         return "违规行为：打劫";
     }
     
     // 检查是否是自杀行为
-    if (isSuicideMove(&game->board, pos)) {
+    if (isSuicideMove(&game->board, vertex)) {
         return "违规行为：自杀";
     }
     
+    // 检查是否重复以前的局面
+    if (isSuperkoMove(&game->board, vertex)) {
+        return "违规行为：全局同形";
+    }
+    
     return NULL;
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+/**
+ * @file groups.c
+ * @brief 增量维护的棋子组表实现
+ */
+
+#include "../include/groups.h"
+#include <string.h>
+
+void buildGroupTable(GroupTable* groups, const uint8_t* board) {
+    memset(groups->groupId, 0, sizeof(groups->groupId));
+    
+    for (int v = 0; v < BOARD_VERTICES; v++) {
+        Stone color = (Stone)board[v];
+        if ((color == BLACK || color == WHITE) && groups->groupId[v] == NO_VERTEX) {
+            buildGroup(groups, board, v);
+        }
+    }
+}
+
+void buildGroup(GroupTable* groups, const uint8_t* board, int seed) {
+    Stone color = (Stone)board[seed];
+    
+    // 用显式栈找出连通的棋子，以起始棋子为代表点串成循环链表
+    int stack[BOARD_SIZE * BOARD_SIZE];
+    int top = 0;
+    int last = seed;
+    int size = 0;
+    stack[top++] = seed;
+    groups->groupId[seed] = (int16_t)seed;
+    
+    while (top > 0) {
+        int s = stack[--top];
+        groups->nextStone[last] = (int16_t)s;
+        last = s;
+        size++;
+        
+        for (int i = 0; i < 4; i++) {
+            int next = s + NEIGHBOR_OFFSETS[i];
+            if (board[next] == color && groups->groupId[next] == NO_VERTEX) {
+                groups->groupId[next] = (int16_t)seed;
+                stack[top++] = next;
+            }
+        }
+    }
+    
+    groups->nextStone[last] = (int16_t)seed;
+    groups->groupStones[seed] = (int16_t)size;
+    groups->groupLibs[seed] = (int16_t)countGroupLiberties(groups, board, seed);
+}
+
+int countGroupLiberties(const GroupTable* groups, const uint8_t* board, int head) {
+    int liberties = 0;
+    int v = head;
+    
+    do {
+        for (int i = 0; i < 4; i++) {
+            int lib = v + NEIGHBOR_OFFSETS[i];
+            if (board[lib] != EMPTY) continue;
+            
+            // 一口气可能与组内多个棋子相邻，只由编号最小的那个棋子计入，不需要清空标记数组
+            bool counted = false;
+            for (int j = 0; j < 4; j++) {
+                int other = lib + NEIGHBOR_OFFSETS[j];
+                if (other < v && groups->groupId[other] == head) {
+                    counted = true;
+                    break;
+                }
+            }
+            if (!counted) liberties++;
+        }
+        v = groups->nextStone[v];
+    } while (v != head);
+    
+    return liberties;
+}
+
+bool isGroupSuicide(const GroupTable* groups, const uint8_t* board, int vertex, Stone color) {
+    for (int i = 0; i < 4; i++) {
+        int next = vertex + NEIGHBOR_OFFSETS[i];
+        Stone neighbor = (Stone)board[next];
+        
+        // 相邻有空位，落子后必然有气
+        if (neighbor == EMPTY) return false;
+        if (neighbor == OFFBOARD) continue;
+        
+        int liberties = groups->groupLibs[groups->groupId[next]];
+        
+        // 连接到落子后仍有气的己方棋子组
+        if (neighbor == color && liberties > 1) return false;
+        
+        // 提取只剩一口气的对方棋子组后获得气
+        if (neighbor != color && liberties == 1) return false;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief 合并两个棋子组（将较小的组并入较大的组）
+ * @param groups 棋子组表
+ * @param a 棋子组代表点
+ * @param b 棋子组代表点
+ * @return 合并后的代表点
+ */
+static int mergeGroups(GroupTable* groups, int a, int b) {
+    if (groups->groupStones[a] < groups->groupStones[b]) {
+        int temp = a;
+        a = b;
+        b = temp;
+    }
+    
+    // 重新标记较小组的棋子
+    int v = b;
+    do {
+        groups->groupId[v] = (int16_t)a;
+        v = groups->nextStone[v];
+    } while (v != b);
+    
+    // 拼接两个循环链表
+    int16_t temp = groups->nextStone[a];
+    groups->nextStone[a] = groups->nextStone[b];
+    groups->nextStone[b] = temp;
+    groups->groupStones[a] += groups->groupStones[b];
+    
+    return a;
+}
+
+int placeGroupStone(GroupTable* groups, uint8_t* board, int vertex, Stone color, int dead[4]) {
+    // 放置棋子，新棋子先单独成组
+    board[vertex] = (uint8_t)color;
+    groups->groupId[vertex] = (int16_t)vertex;
+    groups->nextStone[vertex] = (int16_t)vertex;
+    groups->groupStones[vertex] = 1;
+    groups->groupLibs[vertex] = 0;
+    
+    // 收集相邻的棋子组，落子点是它们各自的一口气
+    int adjGroups[4];
+    int adjCount = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        int next = vertex + NEIGHBOR_OFFSETS[i];
+        
+        if (board[next] == EMPTY) {
+            groups->groupLibs[vertex]++;
+            continue;
+        }
+        if (board[next] == OFFBOARD) continue;
+        
+        int g = groups->groupId[next];
+        bool duplicate = false;
+        for (int j = 0; j < adjCount; j++) {
+            if (adjGroups[j] == g) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) continue;
+        
+        adjGroups[adjCount++] = g;
+        groups->groupLibs[g]--;
+    }
+    
+    // 合并己方相邻棋子组，收集无气的对方棋子组
+    int head = vertex;
+    int friendlyCount = 0;
+    int friendlyLibs = 0;
+    int deadCount = 0;
+    for (int i = 0; i < adjCount; i++) {
+        int g = adjGroups[i];
+        if (board[g] == color) {
+            friendlyLibs = groups->groupLibs[g];
+            head = mergeGroups(groups, head, g);
+            friendlyCount++;
+        } else if (groups->groupLibs[g] == 0) {
+            dead[deadCount++] = g;
+        }
+    }
+    
+    if (friendlyCount == 1) {
+        // 只连接一个组：新增的气是落子点旁边尚未与该组相邻的空位
+        int liberties = friendlyLibs;
+        for (int i = 0; i < 4; i++) {
+            int lib = vertex + NEIGHBOR_OFFSETS[i];
+            if (board[lib] != EMPTY) continue;
+            
+            bool alreadyLiberty = false;
+            for (int j = 0; j < 4; j++) {
+                int next = lib + NEIGHBOR_OFFSETS[j];
+                if (next != vertex && groups->groupId[next] == head) {
+                    alreadyLiberty = true;
+                    break;
+                }
+            }
+            if (!alreadyLiberty) liberties++;
+        }
+        groups->groupLibs[head] = (int16_t)liberties;
+    } else if (friendlyCount > 1) {
+        // 连接多个组时重新计算合并后组的气
+        groups->groupLibs[head] = (int16_t)countGroupLiberties(groups, board, head);
+    }
+    
+    return deadCount;
+}
+
+int removeGroupStones(GroupTable* groups, uint8_t* board, int head) {
+    int removed = 0;
+    int v = head;
+    
+    do {
+        int next = groups->nextStone[v];
+        
+        board[v] = EMPTY;
+        groups->groupId[v] = NO_VERTEX;
+        removed++;
+        
+        // 空出的点是每个相邻棋子组的一口新气
+        int seen[4];
+        int seenCount = 0;
+        for (int i = 0; i < 4; i++) {
+            int g = groups->groupId[v + NEIGHBOR_OFFSETS[i]];
+            if (g == NO_VERTEX || g == head) continue;
+            
+            bool duplicate = false;
+            for (int j = 0; j < seenCount; j++) {
+                if (seen[j] == g) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (duplicate) continue;
+            
+            seen[seenCount++] = g;
+            groups->groupLibs[g]++;
+        }
+        
+        v = next;
+    } while (v != head);
+    
+    return removed;
+}
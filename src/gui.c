@@ -6,6 +6,7 @@
 #include "../include/gui.h"
 #include "../include/utils.h"
 #include <SDL2/SDL_ttf.h>
+#include <limits.h>
 
 // 函数声明
 static void renderText(SDL_Renderer* renderer, const char* text, int x, int y, TTF_Font* font, SDL_Color color);
@@ -119,7 +120,7 @@ bool initGUI(GUI* gui) {
     gui->statusRect.x = BOARD_MARGIN + gui->boardRect.w + 20;
     gui->statusRect.y = BOARD_MARGIN + 60;
     gui->statusRect.w = WINDOW_WIDTH - gui->statusRect.x - 20;
-    gui->statusRect.h = 150;
+    gui->statusRect.h = 180;
     
     gui->violationRect.x = BOARD_MARGIN;
     gui->violationRect.y = BOARD_MARGIN + gui->boardRect.h + 70;
@@ -129,7 +130,7 @@ bool initGUI(GUI* gui) {
     gui->controlsRect.x = BOARD_MARGIN + gui->boardRect.w + 20;
     gui->controlsRect.y = BOARD_MARGIN + gui->statusRect.h + 80;
     gui->controlsRect.w = gui->statusRect.w;
-    gui->controlsRect.h = 200;
+    gui->controlsRect.h = 260;
     
     return true;
 }
@@ -251,13 +252,13 @@ void renderBoard(GUI* gui, Game* game) {
     // 绘制棋子
     for (int y = 0; y < BOARD_SIZE; y++) {
         for (int x = 0; x < BOARD_SIZE; x++) {
-            if (game->board.board[y][x] != EMPTY) {
+            if (game->board.board[VERTEX(x, y)] != EMPTY) {
                 int screenX = gui->boardRect.x + x * CELL_SIZE;
                 int screenY = gui->boardRect.y + y * CELL_SIZE;
                 int radius = CELL_SIZE / 2 - 2;
                 
                 // 设置颜色
-                if (game->board.board[y][x] == BLACK) {
+                if (game->board.board[VERTEX(x, y)] == BLACK) {
                     SDL_SetRenderDrawColor(gui->renderer, 
                                           BLACK_STONE_COLOR.r, 
                                           BLACK_STONE_COLOR.g, 
@@ -284,7 +285,7 @@ void renderBoard(GUI* gui, Game* game) {
                 }
                 
                 // 标记最后一步落子
-                if (x == game->board.lastMove.x && y == game->board.lastMove.y) {
+                if (VERTEX(x, y) == game->board.lastMove) {
                     SDL_SetRenderDrawColor(gui->renderer, 
                                           255 - BLACK_STONE_COLOR.r, 
                                           255 - BLACK_STONE_COLOR.g, 
@@ -336,6 +337,17 @@ void renderStatus(GUI* gui, Game* game) {
     sprintf(statusText, "%s - %s", modeText, playerText);
     renderText(gui->renderer, statusText, gui->statusRect.x + 10, gui->statusRect.y + 130, mediumFont, TEXT_COLOR);
     
+    // AI思考状态和实时模拟次数
+    if (game->aiThinking) {
+        sprintf(statusText, "AI思考中... %d 次模拟", enginePlayouts(&game->engine));
+        renderText(gui->renderer, statusText, gui->statusRect.x + 10, gui->statusRect.y + 160, mediumFont, HINT_COLOR);
+    } else if (game->engine.task == ENGINE_TASK_PONDER) {
+        // 搜索树用满后后台思考已经结束
+        sprintf(statusText, engineTreeFull(&game->engine) ? "搜索树已满: %d 次模拟" : "AI后台思考: %d 次模拟",
+                enginePlayouts(&game->engine));
+        renderText(gui->renderer, statusText, gui->statusRect.x + 10, gui->statusRect.y + 160, mediumFont, HINT_COLOR);
+    }
+    
     // 如果游戏结束，显示胜者
     if (game->state == STATE_GAMEOVER) {
         const char* winnerText = (game->winner == BLACK) ? "黑方胜利!" : 
@@ -398,6 +410,14 @@ void renderControls(GUI* gui, Game* game) {
     renderText(gui->renderer, "[E] 结束游戏", 
               gui->controlsRect.x + 10, gui->controlsRect.y + 160, 
               mediumFont, HINT_COLOR);
+    
+    renderText(gui->renderer, "[Home/End] 开局/最新局面", 
+              gui->controlsRect.x + 10, gui->controlsRect.y + 190, 
+              mediumFont, HINT_COLOR);
+    
+    renderText(gui->renderer, "[PgUp/PgDn] 后退/前进10手", 
+              gui->controlsRect.x + 10, gui->controlsRect.y + 220, 
+              mediumFont, HINT_COLOR);
 }
 
 /**
@@ -467,12 +487,14 @@ bool handleEvents(GUI* gui, Game* game) {
                 if (event.button.button == SDL_BUTTON_LEFT) {
                     Position boardPos;
                     if (screenToBoardPos(gui, event.button.x, event.button.y, &boardPos)) {
+                        int vertex = VERTEX(boardPos.x, boardPos.y);
+                        
                         // 检查落子是否合法
-                        violationMessage = getViolationHint(game, boardPos);
+                        violationMessage = getViolationHint(game, vertex);
                         
                         if (!violationMessage) {
                             // 尝试落子
-                            handlePlayerMove(game, boardPos);
+                            handlePlayerMove(game, vertex);
                         } else {
                             // 渲染违规提示
                             renderViolationHint(gui, game, violationMessage);
@@ -487,7 +509,8 @@ bool handleEvents(GUI* gui, Game* game) {
                 if (game->state == STATE_GAMEOVER) {
                     if (event.key.keysym.sym == SDLK_SPACE || 
                         event.key.keysym.sym == SDLK_RETURN) {
-                        // 初始化新游戏
+                        // 释放旧游戏（包括AI引擎）并初始化新游戏
+                        freeGame(game);
                         initGame(game);
                     }
                     return true;
@@ -512,6 +535,22 @@ bool handleEvents(GUI* gui, Game* game) {
                         handleRedo(game);
                         break;
                         
+                    case SDLK_HOME: // 跳到开局
+                        handleGotoMove(game, 0);
+                        break;
+                        
+                    case SDLK_END: // 跳到最后一手
+                        handleGotoMove(game, INT_MAX);
+                        break;
+                        
+                    case SDLK_PAGEUP: // 后退10手
+                        handleGotoMove(game, game->board.current->moveNumber - 10);
+                        break;
+                        
+                    case SDLK_PAGEDOWN: // 前进10手
+                        handleGotoMove(game, game->board.current->moveNumber + 10);
+                        break;
+                        
                     case SDLK_t: // 切换提示
                         toggleHints(game);
                         break;
@@ -580,9 +619,9 @@ void renderGameOver(GUI* gui, Game* game) {
     
     for (int y = 0; y < BOARD_SIZE; y++) {
         for (int x = 0; x < BOARD_SIZE; x++) {
-            if (game->board.board[y][x] == BLACK) {
+            if (game->board.board[VERTEX(x, y)] == BLACK) {
                 blackStones++;
-            } else if (game->board.board[y][x] == WHITE) {
+            } else if (game->board.board[VERTEX(x, y)] == WHITE) {
                 whiteStones++;
             }
         }
@@ -616,13 +655,13 @@ void renderGameOver(GUI* gui, Game* game) {
               panelRect.x + 50, panelRect.y + 240, 
               mediumFont, TEXT_COLOR);
     
-    sprintf(scoreInfo, "贴目: +4");
+    sprintf(scoreInfo, "贴目: +%.1f", KOMI);
     renderText(gui->renderer, scoreInfo, 
               panelRect.x + 50, panelRect.y + 270, 
               mediumFont, TEXT_COLOR);
     
-    int whiteTotal = whiteStones + game->board.blackCaptures + 4; // 加上贴目
-    sprintf(scoreInfo, "白方总分: %d", whiteTotal);
+    double whiteTotal = whiteStones + game->board.blackCaptures + KOMI; // 加上贴目
+    sprintf(scoreInfo, "白方总分: %.1f", whiteTotal);
     renderText(gui->renderer, scoreInfo, 
               panelRect.x + 50, panelRect.y + 300, 
               mediumFont, TEXT_COLOR);
@@ -0,0 +1,537 @@
+/**
+ * @file playout.c
+ * @brief 搜索与模拟专用的轻量棋盘实现
+ */
+
+#include "../include/playout.h"
+#include <string.h>
+
+// 3×3邻域编码中八个相邻格点的偏移（前四个是上下左右，后四个是对角）
+const int NEIGHBOURHOOD_OFFSETS[8] = {
+    -BOARD_STRIDE, 1, BOARD_STRIDE, -1,
+    -BOARD_STRIDE + 1, BOARD_STRIDE + 1, BOARD_STRIDE - 1, -BOARD_STRIDE - 1
+};
+
+// 八个相邻格点的坐标差（与上面的偏移一一对应）
+static const int NEIGHBOURHOOD_DX[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+static const int NEIGHBOURHOOD_DY[8] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+
+// 3×3模式表的标志位
+#define PATTERN_EYE(color)        (1 << (color))       // 是该方的单点眼
+#define PATTERN_SELF_ATARI(color) (1 << ((color) + 2)) // 该方落子后是只剩一口气的孤子
+#define PATTERN_MOGO              (1 << 5)             // 匹配 MoGo 模式
+
+// 3×3模式表：按邻域编码索引，一次查表即可得到中心空点的全部标志
+static uint8_t patternTable[1 << 16];
+
+// MoGo 的3×3模式（中心是落子点）。X、O 是双方棋子，x、o 表示“不是 X”“不是 O”，
+// “.” 是空点，空格是棋盘外，“?” 任意；旋转、翻转和交换颜色后都算匹配
+static const char* const MOGO_PATTERNS[][3] = {
+    {"XOX", "...", "???"},  // 扳：两边夹
+    {"XO.", "...", "?.?"},  // 扳：不被切断
+    {"XO?", "X..", "x.?"},  // 扳：拐
+    {".O.", "X..", "..."},  // 碰
+    {"XO?", "O.o", "?o?"},  // 断：无人保护
+    {"XO?", "O.X", "???"},  // 断：已被窥视
+    {"?X?", "O.O", "ooo"},  // 断：冲
+    {"OX?", "o.O", "???"},  // 断：小飞
+    {"X.?", "O.?", "   "},  // 边：追
+    {"OX?", "X.O", "   "},  // 边：挡住切断
+    {"?X?", "x.O", "   "},  // 边：挡住联络
+    {"?XO", "x.x", "   "},  // 边：立
+    {"?OX", "X.O", "   "},  // 边：断
+};
+
+/**
+ * @brief 判断邻域编码对应的中心点是否是指定一方的眼
+ */
+static bool neighbourhoodIsEye(int code, Stone color) {
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    
+    // 四个相邻点必须都是己方棋子或棋盘外
+    for (int i = 0; i < 4; i++) {
+        Stone s = (Stone)((code >> (2 * i)) & 3);
+        if (s != color && s != OFFBOARD) return false;
+    }
+    
+    // 对角上的对方棋子：棋盘中间最多一个，边上和角上不能有
+    int opponents = 0;
+    bool edge = false;
+    for (int i = 4; i < 8; i++) {
+        Stone s = (Stone)((code >> (2 * i)) & 3);
+        if (s == opponentColor) opponents++;
+        if (s == OFFBOARD) edge = true;
+    }
+    
+    return edge ? opponents == 0 : opponents <= 1;
+}
+
+/**
+ * @brief 判断指定一方在邻域编码的中心落子后是否是只剩一口气的孤子
+ */
+static bool neighbourhoodIsSelfAtari(int code, Stone color) {
+    int liberties = 0;
+    for (int i = 0; i < 4; i++) {
+        Stone s = (Stone)((code >> (2 * i)) & 3);
+        if (s == color) return false;
+        if (s == EMPTY) liberties++;
+    }
+    
+    return liberties <= 1;
+}
+
+/**
+ * @brief 模式字符在 X 取 colorX 时允许的格点状态（按 Stone 值置位）
+ */
+static int patternCellMask(char c, Stone colorX) {
+    Stone colorO = (colorX == BLACK) ? WHITE : BLACK;
+    int all = (1 << EMPTY) | (1 << BLACK) | (1 << WHITE) | (1 << OFFBOARD);
+    
+    switch (c) {
+        case 'X': return 1 << colorX;
+        case 'O': return 1 << colorO;
+        case 'x': return all & ~(1 << colorX);
+        case 'o': return all & ~(1 << colorO);
+        case '.': return 1 << EMPTY;
+        case ' ': return 1 << OFFBOARD;
+        default:  return all;
+    }
+}
+
+/**
+ * @brief 枚举满足各格点允许状态的全部邻域编码，在模式表中打上标志
+ * @param masks 八个相邻格点允许的状态
+ * @param index 当前枚举的相邻格点
+ * @param code 已确定部分的编码
+ */
+static void markPatternCodes(const int masks[8], int index, int code) {
+    if (index == 8) {
+        patternTable[code] |= PATTERN_MOGO;
+        return;
+    }
+    
+    for (int s = EMPTY; s <= OFFBOARD; s++) {
+        if (masks[index] & (1 << s)) {
+            markPatternCodes(masks, index + 1, code | (s << (2 * index)));
+        }
+    }
+}
+
+/**
+ * @brief 把 MoGo 模式的各种旋转、翻转和颜色交换写入模式表
+ */
+static void markMogoPatterns(void) {
+    int patternCount = (int)(sizeof(MOGO_PATTERNS) / sizeof(MOGO_PATTERNS[0]));
+    
+    for (int p = 0; p < patternCount; p++) {
+        for (int symmetry = 0; symmetry < 8; symmetry++) {
+            for (Stone colorX = BLACK; colorX <= WHITE; colorX++) {
+                int masks[8];
+                
+                for (int i = 0; i < 8; i++) {
+                    // 相邻格点在模式中的坐标，经过对称变换后再取字符
+                    int dx = NEIGHBOURHOOD_DX[i];
+                    int dy = NEIGHBOURHOOD_DY[i];
+                    if (symmetry & 1) dx = -dx;
+                    if (symmetry & 2) dy = -dy;
+                    if (symmetry & 4) {
+                        int temp = dx;
+                        dx = dy;
+                        dy = temp;
+                    }
+                    masks[i] = patternCellMask(MOGO_PATTERNS[p][dy + 1][dx + 1], colorX);
+                }
+                
+                markPatternCodes(masks, 0, 0);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 预先计算3×3模式表（可重复调用）
+ */
+static void initPatternTable(void) {
+    static bool initialized = false;
+    if (initialized) return;
+    
+    for (int code = 0; code < (1 << 16); code++) {
+        uint8_t flags = 0;
+        for (Stone color = BLACK; color <= WHITE; color++) {
+            if (neighbourhoodIsEye(code, color)) flags |= PATTERN_EYE(color);
+            if (neighbourhoodIsSelfAtari(code, color)) flags |= PATTERN_SELF_ATARI(color);
+        }
+        patternTable[code] = flags;
+    }
+    markMogoPatterns();
+    
+    initialized = true;
+}
+
+/**
+ * @brief 格点颜色改变后，更新周围八个格点的邻域编码
+ * @param pb 轻量棋盘
+ * @param vertex 改变颜色的格点
+ * @param change 原颜色与新颜色的异或
+ */
+static void updateNeighbourhoods(PlayoutBoard* pb, int vertex, int change) {
+    // 从相邻格点看回来的方向：上下、左右、两条对角线各自互为相反方向，编号相差 2
+    for (int i = 0; i < 8; i++) {
+        pb->neighbourhood[vertex + NEIGHBOURHOOD_OFFSETS[i]] ^= (uint16_t)(change << (2 * (i ^ 2)));
+    }
+}
+
+/**
+ * @brief 把格点加入空点表
+ */
+static void addEmptyPoint(PlayoutBoard* pb, int vertex) {
+    pb->emptyIndex[vertex] = (int16_t)pb->emptyCount;
+    pb->emptyPoints[pb->emptyCount++] = (int16_t)vertex;
+}
+
+/**
+ * @brief 把格点从空点表中移除（用最后一个空点填补空位）
+ */
+static void removeEmptyPoint(PlayoutBoard* pb, int vertex) {
+    int index = pb->emptyIndex[vertex];
+    int last = pb->emptyPoints[--pb->emptyCount];
+    
+    pb->emptyPoints[index] = (int16_t)last;
+    pb->emptyIndex[last] = (int16_t)index;
+}
+
+void initPlayoutBoard(PlayoutBoard* pb, const Board* board) {
+    initPatternTable();
+    
+    memcpy(pb->board, board->board, sizeof(pb->board));
+    buildGroupTable(&pb->groups, pb->board);
+    pb->hash = board->hash;
+    
+    pb->emptyCount = 0;
+    pb->blackStones = 0;
+    pb->whiteStones = 0;
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            int v = VERTEX(x, y);
+            if (pb->board[v] == EMPTY) {
+                addEmptyPoint(pb, v);
+            } else if (pb->board[v] == BLACK) {
+                pb->blackStones++;
+            } else {
+                pb->whiteStones++;
+            }
+        }
+    }
+    
+    // 邻域编码之后随落子和提子增量更新
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            int v = VERTEX(x, y);
+            int code = 0;
+            for (int i = 0; i < 8; i++) {
+                code |= pb->board[v + NEIGHBOURHOOD_OFFSETS[i]] << (2 * i);
+            }
+            pb->neighbourhood[v] = (uint16_t)code;
+        }
+    }
+    
+    pb->currentPlayer = board->currentPlayer;
+    pb->lastMove = board->lastMove;
+    pb->previousMove = (board->current && board->current->prev) ? board->current->prev->move : NO_VERTEX;
+    pb->koPosition = board->koActive ? board->koPosition : NO_VERTEX;
+    pb->blackCaptures = board->blackCaptures;
+    pb->whiteCaptures = board->whiteCaptures;
+}
+
+uint64_t positionKey(uint64_t hash, Stone player, int koPosition) {
+    // 空点一栏的随机数不参与棋子哈希：格点 0 在边框上，用来区分行棋方，其余用来标记劫
+    if (player == WHITE) hash ^= zobristKeys[EMPTY][0];
+    if (koPosition != NO_VERTEX) hash ^= zobristKeys[EMPTY][koPosition];
+    
+    return hash;
+}
+
+uint64_t playoutKey(const PlayoutBoard* pb) {
+    return positionKey(pb->hash, pb->currentPlayer, pb->koPosition);
+}
+
+uint64_t playoutKeyAfter(const PlayoutBoard* pb, int vertex) {
+    Stone color = pb->currentPlayer;
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    uint64_t hash = pb->hash ^ zobristKeys[color][vertex];
+    
+    // 与 playoutPlay 相同的规则推算提子和劫，但不修改棋盘
+    int captured[4];
+    int capturedCount = 0;
+    int capturedStones = 0;
+    bool isolated = true;
+    int liberties = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        int next = vertex + NEIGHBOR_OFFSETS[i];
+        Stone neighbor = (Stone)pb->board[next];
+        
+        if (neighbor == EMPTY) {
+            liberties++;
+            continue;
+        }
+        if (neighbor == color) {
+            isolated = false;
+            continue;
+        }
+        if (neighbor != opponentColor) continue;
+        
+        int g = pb->groups.groupId[next];
+        if (pb->groups.groupLibs[g] != 1) continue;
+        
+        bool duplicate = false;
+        for (int j = 0; j < capturedCount; j++) {
+            if (captured[j] == g) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) continue;
+        
+        captured[capturedCount++] = g;
+        capturedStones += pb->groups.groupStones[g];
+        
+        int v = g;
+        do {
+            hash ^= zobristKeys[opponentColor][v];
+            v = pb->groups.nextStone[v];
+        } while (v != g);
+    }
+    
+    // 单子提单子，落下的子不与己方相连且只剩提掉的那一口气
+    int koPosition = NO_VERTEX;
+    if (capturedStones == 1 && isolated && liberties == 0) {
+        koPosition = captured[0];
+    }
+    
+    return positionKey(hash, opponentColor, koPosition);
+}
+
+bool playoutIsLegal(const PlayoutBoard* pb, int vertex) {
+    if (pb->board[vertex] != EMPTY || vertex == pb->koPosition) {
+        return false;
+    }
+    
+    return !isGroupSuicide(&pb->groups, pb->board, vertex, pb->currentPlayer);
+}
+
+int playoutNeighbourhood(const PlayoutBoard* pb, int vertex) {
+    return pb->neighbourhood[vertex];
+}
+
+bool playoutIsEye(const PlayoutBoard* pb, int vertex, Stone color) {
+    return patternTable[pb->neighbourhood[vertex]] & PATTERN_EYE(color);
+}
+
+bool playoutIsSelfAtariShape(const PlayoutBoard* pb, int vertex, Stone color) {
+    return patternTable[pb->neighbourhood[vertex]] & PATTERN_SELF_ATARI(color);
+}
+
+bool playoutIsSelfAtari(const PlayoutBoard* pb, int vertex, Stone color) {
+    // 落子后的第一口气，找到第二口不同的气就不是自紧气
+    int liberty = NO_VERTEX;
+    
+    for (int i = 0; i < 4; i++) {
+        int next = vertex + NEIGHBOR_OFFSETS[i];
+        Stone neighbor = (Stone)pb->board[next];
+        
+        if (neighbor == EMPTY) {
+            if (liberty != NO_VERTEX && liberty != next) return false;
+            liberty = next;
+            continue;
+        }
+        if (neighbor == OFFBOARD) continue;
+        
+        int g = pb->groups.groupId[next];
+        
+        // 提子后至少多出提掉的那些点作为气
+        if (neighbor != color) {
+            if (pb->groups.groupLibs[g] == 1) return false;
+            continue;
+        }
+        
+        // 除了落子点还有两口以上的气
+        if (pb->groups.groupLibs[g] > 2) return false;
+        
+        int v = g;
+        do {
+            for (int j = 0; j < 4; j++) {
+                int l = v + NEIGHBOR_OFFSETS[j];
+                if (pb->board[l] != EMPTY || l == vertex) continue;
+                if (liberty != NO_VERTEX && liberty != l) return false;
+                liberty = l;
+            }
+            v = pb->groups.nextStone[v];
+        } while (v != g);
+    }
+    
+    return true;
+}
+
+int playoutGroupLiberty(const PlayoutBoard* pb, int vertex) {
+    int head = pb->groups.groupId[vertex];
+    int v = head;
+    
+    do {
+        for (int i = 0; i < 4; i++) {
+            int next = v + NEIGHBOR_OFFSETS[i];
+            if (pb->board[next] == EMPTY) return next;
+        }
+        v = pb->groups.nextStone[v];
+    } while (v != head);
+    
+    return NO_VERTEX;
+}
+
+bool playoutMatchesPattern(const PlayoutBoard* pb, int vertex) {
+    return patternTable[pb->neighbourhood[vertex]] & PATTERN_MOGO;
+}
+
+int playoutRandomMove(PlayoutBoard* pb, Rng* rng) {
+    int remaining = pb->emptyCount;
+    
+    while (remaining > 0) {
+        int index = rngBelow(rng, remaining);
+        int vertex = pb->emptyPoints[index];
+        if (!playoutIsEye(pb, vertex, pb->currentPlayer) && playoutIsLegal(pb, vertex)) return vertex;
+        
+        // 把不合适的点换到待选范围末尾
+        int last = pb->emptyPoints[--remaining];
+        pb->emptyPoints[index] = (int16_t)last;
+        pb->emptyIndex[last] = (int16_t)index;
+        pb->emptyPoints[remaining] = (int16_t)vertex;
+        pb->emptyIndex[vertex] = (int16_t)remaining;
+    }
+    
+    return NO_VERTEX;
+}
+
+int playoutScore(const PlayoutBoard* pb) {
+    int score = pb->blackStones - pb->whiteStones;
+    
+    bool visited[BOARD_VERTICES];
+    bool visitedReady = false;
+    int stack[BOARD_SIZE * BOARD_SIZE];
+    
+    for (int i = 0; i < pb->emptyCount; i++) {
+        int v = pb->emptyPoints[i];
+        
+        // 相邻点出现过的颜色（按 Stone 值置位）
+        int seen = 0;
+        for (int d = 0; d < 4; d++) {
+            seen |= 1 << pb->board[v + NEIGHBOR_OFFSETS[d]];
+        }
+        
+        // 孤立的空点直接按相邻棋子判断归属
+        if (!(seen & (1 << EMPTY))) {
+            bool black = seen & (1 << BLACK);
+            bool white = seen & (1 << WHITE);
+            if (black && !white) score++;
+            if (white && !black) score--;
+            continue;
+        }
+        
+        // 与其他空点相连：泛洪整块空地（只在需要时才清空标记数组）
+        if (!visitedReady) {
+            memset(visited, 0, sizeof(visited));
+            visitedReady = true;
+        }
+        if (visited[v]) continue;
+        
+        int top = 0;
+        int size = 0;
+        seen = 0;
+        stack[top++] = v;
+        visited[v] = true;
+        
+        while (top > 0) {
+            int current = stack[--top];
+            size++;
+            
+            for (int d = 0; d < 4; d++) {
+                int next = current + NEIGHBOR_OFFSETS[d];
+                if (pb->board[next] == EMPTY) {
+                    if (!visited[next]) {
+                        visited[next] = true;
+                        stack[top++] = next;
+                    }
+                } else {
+                    seen |= 1 << pb->board[next];
+                }
+            }
+        }
+        
+        bool black = seen & (1 << BLACK);
+        bool white = seen & (1 << WHITE);
+        if (black && !white) score += size;
+        if (white && !black) score -= size;
+    }
+    
+    return score;
+}
+
+void playoutPass(PlayoutBoard* pb) {
+    pb->koPosition = NO_VERTEX;
+    pb->previousMove = pb->lastMove;
+    pb->lastMove = NO_VERTEX;
+    pb->currentPlayer = (pb->currentPlayer == BLACK) ? WHITE : BLACK;
+}
+
+int playoutPlay(PlayoutBoard* pb, int vertex) {
+    Stone color = pb->currentPlayer;
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+    
+    // 放置棋子，提取无气的对方棋子组
+    int dead[4];
+    int deadCount = placeGroupStone(&pb->groups, pb->board, vertex, color, dead);
+    pb->hash ^= zobristKeys[color][vertex];
+    updateNeighbourhoods(pb, vertex, color);
+    removeEmptyPoint(pb, vertex);
+    
+    int totalCaptured = 0;
+    int capturedVertex = NO_VERTEX;
+    for (int i = 0; i < deadCount; i++) {
+        if (pb->groups.groupStones[dead[i]] == 1) {
+            capturedVertex = dead[i];
+        }
+        
+        // 提走的棋子从哈希和周围的邻域编码中去掉，空出的点加入空点表
+        int v = dead[i];
+        do {
+            pb->hash ^= zobristKeys[opponentColor][v];
+            updateNeighbourhoods(pb, v, opponentColor);
+            addEmptyPoint(pb, v);
+            v = pb->groups.nextStone[v];
+        } while (v != dead[i]);
+        totalCaptured += removeGroupStones(&pb->groups, pb->board, dead[i]);
+    }
+    
+    if (color == BLACK) {
+        pb->blackStones++;
+        pb->whiteStones -= totalCaptured;
+        pb->blackCaptures += totalCaptured;
+    } else {
+        pb->whiteStones++;
+        pb->blackStones -= totalCaptured;
+        pb->whiteCaptures += totalCaptured;
+    }
+    
+    // 单子提单子且落下的子只剩一口气时形成劫
+    int head = pb->groups.groupId[vertex];
+    pb->koPosition = NO_VERTEX;
+    if (totalCaptured == 1 && capturedVertex != NO_VERTEX &&
+        pb->groups.groupStones[head] == 1 && pb->groups.groupLibs[head] == 1) {
+        pb->koPosition = capturedVertex;
+    }
+    
+    pb->previousMove = pb->lastMove;
+    pb->lastMove = vertex;
+    pb->currentPlayer = opponentColor;
+    
+    return totalCaptured;
+}
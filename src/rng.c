@@ -0,0 +1,35 @@
+/**
+ * @file rng.c
+ * @brief 随机数生成器的播种
+ */
+
+#include "../include/rng.h"
+#include <SDL2/SDL.h>
+
+/**
+ * @brief splitmix64：把任意64位输入打散，用于展开种子
+ */
+static uint64_t splitMix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void seedRng(Rng* rng, uint64_t seed, uint64_t stream) {
+    // 流编号先打散再与种子混合，相邻的流编号得到毫不相关的状态
+    uint64_t mix = stream;
+    uint64_t state = seed ^ splitMix64(&mix);
+    
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitMix64(&state);
+    }
+}
+
+uint64_t freshRngSeed(void) {
+    // 计时器相同时（同一时刻的多次调用）仍用计数器区分
+    static SDL_atomic_t counter;
+    uint64_t state = SDL_GetPerformanceCounter() ^ ((uint64_t)SDL_AtomicAdd(&counter, 1) << 32);
+    
+    return splitMix64(&state);
+}
\ No newline at end of file
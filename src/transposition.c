@@ -0,0 +1,97 @@
+/**
+ * @file transposition.c
+ * @brief 置换表实现
+ */
+
+#include "../include/transposition.h"
+#include "../include/ai.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool initTranspositionTable(TranspositionTable* table, size_t maxBytes) {
+    // 取不超过内存上限的最大的2的幂
+    size_t count = 0;
+    if (maxBytes / sizeof(void*) >= TRANSPOSITION_BUCKET) {
+        count = TRANSPOSITION_BUCKET;
+        while (count * 2 * sizeof(void*) <= maxBytes && count * 2 <= (size_t)1 << 30) {
+            count *= 2;
+        }
+    }
+    
+    table->slots = NULL;
+    table->slotCount = 0;
+    if (count == 0) return true;
+    
+    table->slots = (void**)calloc(count, sizeof(void*));
+    if (!table->slots) return false;
+    
+    table->slotCount = (int)count;
+    return true;
+}
+
+void freeTranspositionTable(TranspositionTable* table) {
+    free(table->slots);
+    table->slots = NULL;
+    table->slotCount = 0;
+}
+
+void clearTranspositionTable(TranspositionTable* table) {
+    if (table->slots) {
+        memset(table->slots, 0, sizeof(void*) * table->slotCount);
+    }
+}
+
+/**
+ * @brief 局面键所在桶的第一个槽
+ */
+static void** bucketOf(TranspositionTable* table, uint64_t key) {
+    size_t index = (size_t)key & (size_t)(table->slotCount - 1);
+    return table->slots + (index & ~(size_t)(TRANSPOSITION_BUCKET - 1));
+}
+
+MCTSNode* lookupTransposition(TranspositionTable* table, uint64_t key) {
+    if (table->slotCount == 0) return NULL;
+    
+    void** bucket = bucketOf(table, key);
+    for (int i = 0; i < TRANSPOSITION_BUCKET; i++) {
+        MCTSNode* node = (MCTSNode*)SDL_AtomicGetPtr(&bucket[i]);
+        if (node && node->key == key) return node;
+    }
+    
+    return NULL;
+}
+
+void storeTransposition(TranspositionTable* table, MCTSNode* node) {
+    if (table->slotCount == 0) return;
+    
+    void** bucket = bucketOf(table, node->key);
+    void** victim = NULL;
+    MCTSNode* victimNode = NULL;
+    int victimVisits = 0;
+    
+    for (int i = 0; i < TRANSPOSITION_BUCKET; i++) {
+        MCTSNode* occupant = (MCTSNode*)SDL_AtomicGetPtr(&bucket[i]);
+        
+        // 空槽直接占用
+        if (!occupant) {
+            if (SDL_AtomicCASPtr(&bucket[i], NULL, node)) return;
+            occupant = (MCTSNode*)SDL_AtomicGetPtr(&bucket[i]);
+            if (!occupant) continue;
+        }
+        
+        // 已经有代表该局面的节点
+        if (occupant->key == node->key) return;
+        
+        // 替换策略：保留访问次数多的节点，它们更可能再次被置换命中
+        int visits = SDL_AtomicGet(&occupant->visits);
+        if (!victim || visits < victimVisits) {
+            victim = &bucket[i];
+            victimNode = occupant;
+            victimVisits = visits;
+        }
+    }
+    
+    if (victim) {
+        SDL_AtomicCASPtr(victim, victimNode, node);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,504 @@
+/**
+ * @file test_board.c
+ * @brief 棋盘回归测试：增量维护的气数与逐点搜索的结果对照
+ *
+ * 两种棋盘后端各编译一份，运行时把随机对局的摘要写入参数指定的文件，
+ * 由 make test 比较两份摘要是否一致。
+ */
+
+#include "../include/board.h"
+#include <string.h>
+
+static int failures = 0;
+static uint64_t digest = 1469598103934665603ULL;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+/**
+ * @brief 测试专用的线性同余随机数（不依赖平台的 rand）
+ */
+static unsigned int nextRandom(unsigned int* state) {
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7FFF;
+}
+
+/**
+ * @brief 把当前局面（棋盘、提子数、气数、打劫和行棋方）累加到对局摘要
+ */
+static void updateDigest(Board* board) {
+    int fields[8] = {board->blackCaptures, board->whiteCaptures, board->blackLiberties,
+                     board->whiteLiberties, board->koActive, board->koPosition,
+                     board->lastMove, board->currentPlayer};
+    const unsigned char* bytes[2] = {board->board, (const unsigned char*)fields};
+    size_t sizes[2] = {sizeof(board->board), sizeof(fields)};
+
+    for (int part = 0; part < 2; part++) {
+        for (size_t i = 0; i < sizes[part]; i++) {
+            digest = (digest ^ bytes[part][i]) * 1099511628211ULL;
+        }
+    }
+}
+
+/**
+ * @brief 逐点搜索计算棋子组的气数（对照用）
+ */
+static int referenceLiberties(const uint8_t* stones, int vertex) {
+    bool visited[BOARD_VERTICES] = {false};
+    bool counted[BOARD_VERTICES] = {false};
+    int stack[BOARD_VERTICES];
+    int top = 0;
+    int liberties = 0;
+    Stone color = (Stone)stones[vertex];
+
+    visited[vertex] = true;
+    stack[top++] = vertex;
+    while (top > 0) {
+        int v = stack[--top];
+        for (int i = 0; i < 4; i++) {
+            int next = v + NEIGHBOR_OFFSETS[i];
+
+            if (stones[next] == EMPTY && !counted[next]) {
+                counted[next] = true;
+                liberties++;
+            } else if (stones[next] == color && !visited[next]) {
+                visited[next] = true;
+                stack[top++] = next;
+            }
+        }
+    }
+
+    return liberties;
+}
+
+/**
+ * @brief 按规则直接计算落子后的棋盘（对照用）
+ * @return 落子后己方棋子组是否有气（false 表示自杀）
+ */
+static bool referencePlay(const uint8_t* stones, int vertex, Stone color, uint8_t* result) {
+    Stone opponentColor = (color == BLACK) ? WHITE : BLACK;
+
+    memcpy(result, stones, BOARD_VERTICES);
+    result[vertex] = (uint8_t)color;
+
+    // 提掉相邻的无气对方棋子组
+    for (int i = 0; i < 4; i++) {
+        int next = vertex + NEIGHBOR_OFFSETS[i];
+        if (result[next] != opponentColor || referenceLiberties(result, next) > 0) continue;
+
+        int stack[BOARD_VERTICES];
+        int top = 0;
+        result[next] = EMPTY;
+        stack[top++] = next;
+        while (top > 0) {
+            int v = stack[--top];
+            for (int j = 0; j < 4; j++) {
+                int w = v + NEIGHBOR_OFFSETS[j];
+                if (result[w] != opponentColor) continue;
+                result[w] = EMPTY;
+                stack[top++] = w;
+            }
+        }
+    }
+
+    return referenceLiberties(result, vertex) > 0;
+}
+
+/**
+ * @brief 检查每个棋子的气数和双方气数总和
+ */
+static void checkLiberties(Board* board) {
+    int totals[3] = {0, 0, 0};
+    bool counted[BOARD_VERTICES] = {false};
+
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            int vertex = VERTEX(x, y);
+            Stone color = (Stone)board->board[vertex];
+            if (color == EMPTY || counted[vertex]) continue;
+
+            // 每个棋子组搜索一次，组内每个棋子查询到的气数都应相同
+            int liberties = referenceLiberties(board->board, vertex);
+            totals[color] += liberties;
+
+            int stack[BOARD_VERTICES];
+            int top = 0;
+            counted[vertex] = true;
+            stack[top++] = vertex;
+            while (top > 0) {
+                int v = stack[--top];
+                CHECK(countLiberties(board, v) == liberties);
+                CHECK(hasLiberty(board, v));
+
+                for (int i = 0; i < 4; i++) {
+                    int next = v + NEIGHBOR_OFFSETS[i];
+                    if (board->board[next] != color || counted[next]) continue;
+                    counted[next] = true;
+                    stack[top++] = next;
+                }
+            }
+        }
+    }
+
+    CHECK(board->blackLiberties == totals[BLACK]);
+    CHECK(board->whiteLiberties == totals[WHITE]);
+}
+
+/**
+ * @brief 依次落子，每步都必须成功
+ */
+static void playMoves(Board* board, const int moves[][2], int count) {
+    for (int i = 0; i < count; i++) {
+        CHECK(placeStone(board, VERTEX(moves[i][0], moves[i][1])));
+    }
+}
+
+/**
+ * @brief 提子、打劫和自杀的基本规则
+ */
+static void testRules(void) {
+    Board board;
+
+    // 黑方围住 (1,1) 的白子并提取
+    initBoard(&board);
+    const int capture[][2] = {{1, 0}, {1, 1}, {0, 1}, {10, 10}, {2, 1}, {12, 12}, {1, 2}};
+    playMoves(&board, capture, 7);
+    CHECK(board.board[VERTEX(1, 1)] == EMPTY);
+    CHECK(board.blackCaptures == 1);
+    checkLiberties(&board);
+
+    // 白方不能下在没有气且不能提子的 (1,1)
+    int suicide = VERTEX(1, 1);
+    CHECK(isSuicideMove(&board, suicide));
+    CHECK(!placeStone(&board, suicide));
+    freeBoard(&board);
+
+    // 打劫：白方提一子后，黑方不能立即提回
+    initBoard(&board);
+    const int ko[][2] = {{1, 0}, {2, 0}, {0, 1}, {3, 1}, {1, 2}, {2, 2}, {15, 15}, {1, 1}, {2, 1}};
+    playMoves(&board, ko, 9);
+    CHECK(board.board[VERTEX(1, 1)] == EMPTY);
+    CHECK(board.koActive);
+    int retake = VERTEX(1, 1);
+    CHECK(isKoMove(&board, retake));
+    CHECK(!placeStone(&board, retake));
+    checkLiberties(&board);
+    freeBoard(&board);
+}
+
+/**
+ * @brief 数子法判定：棋子加只与一方相邻的空地，白方再加半目贴目
+ */
+static void testScoring(void) {
+    Board board;
+    initBoard(&board);
+
+    // 黑方在四个角各围一个单点眼，白方在中间下同样多的棋子，中间的大块空地双方都相邻
+    const int moves[][2] = {
+        {1, 0}, {5, 5}, {0, 1}, {5, 7}, {17, 0}, {5, 9}, {18, 1}, {5, 11},
+        {0, 17}, {7, 5}, {1, 18}, {7, 7}, {17, 18}, {7, 9}, {18, 17}, {7, 11}
+    };
+    playMoves(&board, moves, 16);
+
+    // 黑 8 子 4 目，白 8 子：黑方多 4 目，不足贴目
+    CHECK(determineWinner(&board) == WHITE);
+
+    // 黑方再多一子，多出 5 目，超过贴目
+    CHECK(placeStone(&board, VERTEX(13, 13)));
+    CHECK(determineWinner(&board) == BLACK);
+
+    freeBoard(&board);
+}
+
+/**
+ * @brief 随机对局：每一步、每次悔棋和前进之后对照气数
+ */
+static void testRandomGames(void) {
+    unsigned int seed = 20240601u;
+
+    for (int game = 0; game < 20; game++) {
+        Board board;
+        initBoard(&board);
+
+        for (int step = 0; step < 4000; step++) {
+            unsigned int r = nextRandom(&seed) % 20;
+            if (r == 0) {
+                undoMove(&board);
+            } else if (r == 1) {
+                redoMove(&board);
+            } else {
+                int x = (int)(nextRandom(&seed) % BOARD_SIZE);
+                int y = (int)(nextRandom(&seed) % BOARD_SIZE);
+                if (!isValidMove(&board, VERTEX(x, y))) continue;
+                CHECK(placeStone(&board, VERTEX(x, y)));
+            }
+            checkLiberties(&board);
+            updateDigest(&board);
+            if (failures > 20) return;
+        }
+
+        int winner = determineWinner(&board);
+        digest = (digest ^ (uint64_t)winner) * 1099511628211ULL;
+
+        freeBoard(&board);
+    }
+}
+
+// 历史记录测试中每手之后的局面（下标为手数）
+#define HISTORY_MOVES 100
+
+typedef struct {
+    uint8_t stones[BOARD_VERTICES];
+    int fields[8];
+    uint64_t hash;
+} Snapshot;
+
+static Snapshot snapshots[HISTORY_MOVES + 1];
+
+/**
+ * @brief 记录当前局面
+ */
+static void takeSnapshot(Board* board, Snapshot* snapshot) {
+    int fields[8] = {board->blackCaptures, board->whiteCaptures, board->blackLiberties,
+                     board->whiteLiberties, board->koActive, board->koPosition,
+                     board->lastMove, board->currentPlayer};
+    memcpy(snapshot->stones, board->board, BOARD_VERTICES);
+    memcpy(snapshot->fields, fields, sizeof(fields));
+    snapshot->hash = board->hash;
+}
+
+/**
+ * @brief 检查当前局面与记录的第 moveNumber 手之后的局面相同，且派生数据正确
+ */
+static void checkSnapshot(Board* board, int moveNumber) {
+    Snapshot now;
+    memset(&now, 0, sizeof(now));
+    takeSnapshot(board, &now);
+    CHECK(memcmp(&now, &snapshots[moveNumber], sizeof(now)) == 0);
+    CHECK(board->current->moveNumber == moveNumber);
+    CHECK(board->seenCount == moveNumber + 1);
+    checkLiberties(board);
+}
+
+/**
+ * @brief 历史记录：悔棋、前进和跳转（含关键帧前后的手数）都要回到落子时的局面
+ */
+static void testHistory(void) {
+    unsigned int seed = 20240603u;
+    Board board;
+    initBoard(&board);
+    memset(snapshots, 0, sizeof(snapshots));
+    takeSnapshot(&board, &snapshots[0]);
+
+    // 先在角上的小范围内落子，保证历史记录里有提子；小范围下满后改为全盘落子
+    int moves = 0;
+    int captures = 0;
+    int range = 7;
+    for (int tries = 0; moves < HISTORY_MOVES; tries++) {
+        if (tries == 2000) range = BOARD_SIZE;
+        int vertex = VERTEX((int)(nextRandom(&seed) % range), (int)(nextRandom(&seed) % range));
+        if (!placeStone(&board, vertex)) continue;
+        captures += board.current->capturedCount;
+        takeSnapshot(&board, &snapshots[++moves]);
+    }
+    CHECK(captures > 0);
+
+    for (int n = HISTORY_MOVES - 1; n >= 0; n--) {
+        CHECK(undoMove(&board));
+        checkSnapshot(&board, n);
+    }
+    CHECK(!undoMove(&board));
+
+    for (int n = 1; n <= HISTORY_MOVES; n++) {
+        CHECK(redoMove(&board));
+        checkSnapshot(&board, n);
+    }
+    CHECK(!redoMove(&board));
+
+    const int targets[] = {0, 17, 31, 32, 33, 63, 64, 65, HISTORY_MOVES, 32, 0};
+    for (int i = 0; i < (int)(sizeof(targets) / sizeof(targets[0])); i++) {
+        CHECK(gotoMove(&board, targets[i]));
+        checkSnapshot(&board, targets[i]);
+    }
+    CHECK(!gotoMove(&board, HISTORY_MOVES + 1));
+
+    // 跳转之后继续悔棋和前进
+    CHECK(gotoMove(&board, 33));
+    CHECK(undoMove(&board));
+    checkSnapshot(&board, 32);
+    CHECK(undoMove(&board));
+    checkSnapshot(&board, 31);
+    CHECK(redoMove(&board));
+    CHECK(redoMove(&board));
+    CHECK(redoMove(&board));
+    checkSnapshot(&board, 34);
+
+    freeBoard(&board);
+}
+
+/**
+ * @brief 三劫循环：每一步都不违反简单劫，但第六步会重现循环开始时的局面
+ */
+static void testTripleKo(void) {
+    // 三个劫的位置：黑子在 (x+1,y) (x,y+1) (x+1,y+2)，白子在 (x+2,y) (x+3,y+1) (x+2,y+2)，
+    // 劫争点是 (x+1,y+1)（白子在此时黑方可提）和 (x+2,y+1)（黑子在此时白方可提）
+    const int origins[3] = {2, 8, 14};
+    int black[11], white[11];
+    int blackCount = 0, whiteCount = 0;
+
+    for (int k = 0; k < 3; k++) {
+        int x = origins[k];
+        black[blackCount++] = VERTEX(x + 1, 2);
+        black[blackCount++] = VERTEX(x, 3);
+        black[blackCount++] = VERTEX(x + 1, 4);
+        white[whiteCount++] = VERTEX(x + 2, 2);
+        white[whiteCount++] = VERTEX(x + 3, 3);
+        white[whiteCount++] = VERTEX(x + 2, 4);
+    }
+
+    // 第一、三个劫是白子在内，第二个劫是黑子在内；再补一手黑棋，轮到黑方
+    white[whiteCount++] = VERTEX(origins[0] + 1, 3);
+    black[blackCount++] = VERTEX(origins[1] + 2, 3);
+    white[whiteCount++] = VERTEX(origins[2] + 1, 3);
+    black[blackCount++] = VERTEX(10, 15);
+
+    Board board;
+    initBoard(&board);
+    for (int i = 0; i < 11; i++) {
+        CHECK(placeStone(&board, black[i]));
+        CHECK(placeStone(&board, white[i]));
+    }
+
+    // 黑提劫一、白提劫二、黑提劫三、白提劫一、黑提劫二
+    const int cycle[5][2] = {
+        {origins[0] + 2, 3}, {origins[1] + 1, 3}, {origins[2] + 2, 3},
+        {origins[0] + 1, 3}, {origins[1] + 2, 3}
+    };
+    int captures = board.blackCaptures + board.whiteCaptures;
+    playMoves(&board, cycle, 5);
+    CHECK(board.blackCaptures + board.whiteCaptures == captures + 5);
+
+    // 白提劫三会回到循环开始时的局面：不是简单劫，但违反全局同形
+    int repeat = VERTEX(origins[2] + 1, 3);
+    CHECK(!isKoMove(&board, repeat));
+    CHECK(!isSuicideMove(&board, repeat));
+    CHECK(!isValidMove(&board, repeat));
+    CHECK(!placeStone(&board, repeat));
+
+    freeBoard(&board);
+}
+
+// 全局同形测试中记录的棋局路线（下标为手数）
+#define LINE_LIMIT 4000
+static uint8_t linePositions[LINE_LIMIT + 1][BOARD_VERTICES];
+static uint64_t lineHashes[LINE_LIMIT + 1];
+
+/**
+ * @brief 计算棋子分布的 FNV 哈希（对照用，与棋盘的 Zobrist 哈希无关）
+ */
+static uint64_t positionHash(const uint8_t* stones) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (int v = 0; v < BOARD_VERTICES; v++) {
+        hash = (hash ^ stones[v]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief 检查局面是否在路线的前 length 个局面中出现过
+ */
+static bool lineContains(int length, const uint8_t* stones) {
+    uint64_t hash = positionHash(stones);
+    for (int i = 0; i < length; i++) {
+        if (lineHashes[i] == hash && memcmp(linePositions[i], stones, BOARD_VERTICES) == 0) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 把当前局面记到路线的第 index 个位置
+ */
+static void recordLine(int index, Board* board) {
+    memcpy(linePositions[index], board->board, BOARD_VERTICES);
+    lineHashes[index] = positionHash(board->board);
+}
+
+/**
+ * @brief 全局同形：随机长对局中逐点对照 isValidMove 与穷举路线的结果
+ *
+ * 测试程序用很小的 POSITION_SET_SIZE 编译，对局中局面集合会多次扩容，悔棋时也会删除局面。
+ */
+static void testSuperko(void) {
+    unsigned int seed = 7u;
+    int length = 0;
+    int repeats = 0;
+    Board board;
+    initBoard(&board);
+    recordLine(length++, &board);
+
+    for (int step = 0; step < 100000 && length <= LINE_LIMIT; step++) {
+        unsigned int r = nextRandom(&seed) % 50;
+        if (r == 0) {
+            if (undoMove(&board)) length--;
+            continue;
+        }
+        if (r == 1) {
+            if (redoMove(&board)) recordLine(length++, &board);
+            continue;
+        }
+
+        int vertex = VERTEX((int)(nextRandom(&seed) % BOARD_SIZE), (int)(nextRandom(&seed) % BOARD_SIZE));
+        if (board.board[vertex] != EMPTY) continue;
+
+        // 合法当且仅当落子后有气且局面没有在路线上出现过
+        uint8_t result[BOARD_VERTICES];
+        bool legal = referencePlay(board.board, vertex, board.currentPlayer, result);
+        if (legal && lineContains(length, result)) {
+            legal = false;
+            repeats++;
+        }
+        CHECK(isValidMove(&board, vertex) == legal);
+        if (!legal) continue;
+
+        CHECK(placeStone(&board, vertex));
+        CHECK(memcmp(board.board, result, BOARD_VERTICES) == 0);
+        recordLine(length++, &board);
+        if (failures > 20) break;
+    }
+
+    // 对局足够长且确实遇到了同形
+    CHECK(length > POSITION_SET_SIZE);
+    CHECK(repeats > 0);
+    freeBoard(&board);
+}
+
+int main(int argc, char* argv[]) {
+    testRules();
+    testScoring();
+    testRandomGames();
+    testHistory();
+    testTripleKo();
+    testSuperko();
+
+    // 写出对局摘要，供不同后端之间比较
+    if (argc > 1) {
+        FILE* file = fopen(argv[1], "w");
+        if (!file) {
+            printf("test_board: 无法写入摘要文件 %s\n", argv[1]);
+            return 1;
+        }
+        fprintf(file, "%016llx\n", (unsigned long long)digest);
+        fclose(file);
+    }
+
+    if (failures > 0) {
+        printf("test_board: %d 项检查失败\n", failures);
+        return 1;
+    }
+    printf("test_board: 全部通过\n");
+    return 0;
+}
@@ -0,0 +1,313 @@
+/**
+ * @file test_playout.c
+ * @brief 轻量棋盘回归测试：PlayoutBoard 与完整的 Board 同步落子，逐步对照结果
+ */
+
+#include "../include/playout.h"
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+/**
+ * @brief 测试专用的线性同余随机数（不依赖平台的 rand）
+ */
+static unsigned int nextRandom(unsigned int* state) {
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7FFF;
+}
+
+/**
+ * @brief 逐个读取八个相邻格点计算3×3邻域编码（对照用，顺序为上、右、下、左、右上、右下、左下、左上）
+ */
+static int referenceNeighbourhood(const uint8_t* stones, int x, int y) {
+    static const int dx[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+    static const int dy[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
+    int code = 0;
+    for (int i = 0; i < 8; i++) {
+        code |= stones[VERTEX(x + dx[i], y + dy[i])] << (2 * i);
+    }
+    return code;
+}
+
+/**
+ * @brief 逐块泛洪计算数子法的黑白差（对照用）：棋子加只与一方相邻的空地
+ */
+static int referenceScore(const uint8_t* stones) {
+    bool visited[BOARD_VERTICES] = {false};
+    int score = 0;
+
+    for (int v = 0; v < BOARD_VERTICES; v++) {
+        if (stones[v] == BLACK) score++;
+        if (stones[v] == WHITE) score--;
+        if (stones[v] != EMPTY || visited[v]) continue;
+
+        int queue[BOARD_SIZE * BOARD_SIZE];
+        int front = 0, rear = 0;
+        bool touchesBlack = false;
+        bool touchesWhite = false;
+        queue[rear++] = v;
+        visited[v] = true;
+
+        while (front < rear) {
+            int current = queue[front++];
+            for (int d = 0; d < 4; d++) {
+                int next = current + NEIGHBOR_OFFSETS[d];
+                if (stones[next] == EMPTY && !visited[next]) {
+                    visited[next] = true;
+                    queue[rear++] = next;
+                }
+                if (stones[next] == BLACK) touchesBlack = true;
+                if (stones[next] == WHITE) touchesWhite = true;
+            }
+        }
+
+        if (touchesBlack && !touchesWhite) score += rear;
+        if (touchesWhite && !touchesBlack) score -= rear;
+    }
+
+    return score;
+}
+
+/**
+ * @brief 对照两个棋盘的棋子、哈希、棋子组气数、提子数、劫和行棋方，并检查空点表、邻域编码和数子结果
+ */
+static void checkSame(Board* board, const PlayoutBoard* pb) {
+    CHECK(memcmp(board->board, pb->board, sizeof(pb->board)) == 0);
+    CHECK(board->hash == pb->hash);
+    CHECK(board->blackCaptures == pb->blackCaptures);
+    CHECK(board->whiteCaptures == pb->whiteCaptures);
+    CHECK(board->currentPlayer == pb->currentPlayer);
+    CHECK(board->lastMove == pb->lastMove);
+    CHECK((board->current->prev ? board->current->prev->move : NO_VERTEX) == pb->previousMove);
+    CHECK((board->koActive ? board->koPosition : NO_VERTEX) == pb->koPosition);
+
+    int black = 0;
+    int white = 0;
+    int empty = 0;
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            int v = VERTEX(x, y);
+            CHECK(playoutNeighbourhood(pb, v) == referenceNeighbourhood(pb->board, x, y));
+            if (pb->board[v] == EMPTY) {
+                CHECK(pb->groups.groupId[v] == NO_VERTEX);
+                CHECK(pb->emptyIndex[v] >= 0 && pb->emptyIndex[v] < pb->emptyCount);
+                CHECK(pb->emptyPoints[pb->emptyIndex[v]] == v);
+                empty++;
+                continue;
+            }
+
+            if (pb->board[v] == BLACK) black++;
+            if (pb->board[v] == WHITE) white++;
+            int head = pb->groups.groupId[v];
+            CHECK(pb->board[head] == pb->board[v]);
+            CHECK(pb->groups.groupLibs[head] == countLiberties(board, v));
+            if (pb->groups.groupLibs[head] > 0) CHECK(pb->board[playoutGroupLiberty(pb, v)] == EMPTY);
+        }
+    }
+    CHECK(pb->emptyCount == empty);
+    CHECK(pb->blackStones == black);
+    CHECK(pb->whiteStones == white);
+    CHECK(playoutScore(pb) == referenceScore(pb->board));
+}
+
+/**
+ * @brief 随机落子：选出的点合法且不是自己的眼，只有没有这样的点时才返回 NO_VERTEX
+ */
+static void checkRandomMove(PlayoutBoard* pb, Rng* rng) {
+    int move = playoutRandomMove(pb, rng);
+    if (move != NO_VERTEX) {
+        CHECK(playoutIsLegal(pb, move));
+        CHECK(!playoutIsEye(pb, move, pb->currentPlayer));
+        return;
+    }
+
+    for (int i = 0; i < pb->emptyCount; i++) {
+        int v = pb->emptyPoints[i];
+        CHECK(!playoutIsLegal(pb, v) || playoutIsEye(pb, v, pb->currentPlayer));
+    }
+}
+
+/**
+ * @brief 自紧气判断：在副本上实际落子，没有提子且落下的棋子组最多只剩一口气
+ */
+static void checkSelfAtari(const PlayoutBoard* pb, int vertex) {
+    if (!playoutIsLegal(pb, vertex)) return;
+
+    PlayoutBoard copy = *pb;
+    int captured = playoutPlay(&copy, vertex);
+    bool selfAtari = captured == 0 && copy.groups.groupLibs[copy.groups.groupId[vertex]] <= 1;
+    CHECK(playoutIsSelfAtari(pb, vertex, pb->currentPlayer) == selfAtari);
+}
+
+/**
+ * @brief 随机对局：两个棋盘的合法性判断和落子结果必须一致
+ */
+static void testRandomGames(void) {
+    unsigned int seed = 20240602u;
+    Rng rng = {{0x9E3779B97F4A7C15ULL, 1, 2, 3}}; // 不经过 seedRng，测试不链接 rng.c
+
+    for (int game = 0; game < 20; game++) {
+        Board board;
+        PlayoutBoard pb;
+        initBoard(&board);
+        initPlayoutBoard(&pb, &board);
+
+        for (int step = 0; step < 4000; step++) {
+            // 悔棋后轻量棋盘没有历史可退，重新拍快照
+            if (nextRandom(&seed) % 40 == 0) {
+                undoMove(&board);
+                initPlayoutBoard(&pb, &board);
+                checkSame(&board, &pb);
+                continue;
+            }
+
+            int vertex = VERTEX((int)(nextRandom(&seed) % BOARD_SIZE), (int)(nextRandom(&seed) % BOARD_SIZE));
+
+            // 轻量棋盘只检查简单劫，其余规则与完整棋盘相同
+            bool simpleLegal = board.board[vertex] == EMPTY && !isSuicideMove(&board, vertex) &&
+                               !isKoMove(&board, vertex);
+            CHECK(playoutIsLegal(&pb, vertex) == simpleLegal);
+            if (isValidMove(&board, vertex)) CHECK(simpleLegal);
+            if (!isValidMove(&board, vertex)) continue;
+
+            int captured = board.blackCaptures + board.whiteCaptures;
+            CHECK(placeStone(&board, vertex));
+            CHECK(playoutPlay(&pb, vertex) == board.blackCaptures + board.whiteCaptures - captured);
+            checkSame(&board, &pb);
+            for (int i = 0; i < 4; i++) {
+                checkSelfAtari(&pb, VERTEX((int)(nextRandom(&seed) % BOARD_SIZE), (int)(nextRandom(&seed) % BOARD_SIZE)));
+            }
+            checkRandomMove(&pb, &rng);
+            checkSame(&board, &pb);
+            if (failures > 20) return;
+        }
+
+        freeBoard(&board);
+    }
+}
+
+/**
+ * @brief 单点眼的判断：角上和边上不能有对方的对角棋子，中间最多一个
+ */
+static void testEyes(void) {
+    Board board;
+    initBoard(&board);
+    PlayoutBoard pb;
+
+    // 角上：两个相邻点是黑子
+    board.board[VERTEX(1, 0)] = BLACK;
+    board.board[VERTEX(0, 1)] = BLACK;
+    initPlayoutBoard(&pb, &board);
+    CHECK(playoutIsEye(&pb, VERTEX(0, 0), BLACK));
+    CHECK(!playoutIsEye(&pb, VERTEX(0, 0), WHITE));
+
+    board.board[VERTEX(1, 1)] = WHITE;
+    initPlayoutBoard(&pb, &board);
+    CHECK(!playoutIsEye(&pb, VERTEX(0, 0), BLACK));
+
+    // 中间：四面黑子，对角的白子最多一个
+    int center = VERTEX(9, 9);
+    for (int i = 0; i < 4; i++) {
+        board.board[center + NEIGHBOR_OFFSETS[i]] = BLACK;
+    }
+    board.board[VERTEX(8, 8)] = WHITE;
+    initPlayoutBoard(&pb, &board);
+    CHECK(playoutIsEye(&pb, center, BLACK));
+
+    board.board[VERTEX(10, 10)] = WHITE;
+    initPlayoutBoard(&pb, &board);
+    CHECK(!playoutIsEye(&pb, center, BLACK));
+
+    // 有一面不是己方棋子就不是眼
+    board.board[VERTEX(10, 10)] = EMPTY;
+    board.board[VERTEX(9, 8)] = EMPTY;
+    initPlayoutBoard(&pb, &board);
+    CHECK(!playoutIsEye(&pb, center, BLACK));
+
+    freeBoard(&board);
+}
+
+/**
+ * @brief 3×3模式表：MoGo 模式在旋转和交换颜色后都能匹配，自紧气形状只看相邻点
+ */
+static void testPatterns(void) {
+    Board board;
+    initBoard(&board);
+    PlayoutBoard pb;
+    int center = VERTEX(9, 9);
+
+    // 空棋盘上没有任何模式
+    initPlayoutBoard(&pb, &board);
+    CHECK(!playoutMatchesPattern(&pb, center));
+    CHECK(!playoutIsSelfAtariShape(&pb, center, BLACK));
+
+    // 只有一颗相邻的棋子也不构成模式
+    board.board[VERTEX(9, 8)] = WHITE;
+    initPlayoutBoard(&pb, &board);
+    CHECK(!playoutMatchesPattern(&pb, center));
+
+    // 扳（两边夹）：上方一行是黑白黑，中间一行是空点
+    board.board[VERTEX(8, 8)] = BLACK;
+    board.board[VERTEX(10, 8)] = BLACK;
+    initPlayoutBoard(&pb, &board);
+    CHECK(playoutMatchesPattern(&pb, center));
+    freeBoard(&board);
+
+    // 同一形状旋转到左侧并交换颜色
+    initBoard(&board);
+    board.board[VERTEX(8, 8)] = WHITE;
+    board.board[VERTEX(8, 9)] = BLACK;
+    board.board[VERTEX(8, 10)] = WHITE;
+    initPlayoutBoard(&pb, &board);
+    CHECK(playoutMatchesPattern(&pb, center));
+    freeBoard(&board);
+
+    // 边上的追：下方是棋盘外
+    initBoard(&board);
+    int edge = VERTEX(9, 18);
+    board.board[VERTEX(8, 17)] = BLACK;
+    board.board[VERTEX(8, 18)] = WHITE;
+    initPlayoutBoard(&pb, &board);
+    CHECK(playoutMatchesPattern(&pb, edge));
+
+    // 角上紧贴白子：黑方落子只剩一口气，白方落子与己方棋子相连
+    int corner = VERTEX(0, 0);
+    board.board[VERTEX(1, 0)] = WHITE;
+    initPlayoutBoard(&pb, &board);
+    CHECK(playoutIsSelfAtariShape(&pb, corner, BLACK));
+    CHECK(!playoutIsSelfAtariShape(&pb, corner, WHITE));
+
+    // 邻域编码随落子和提子增量更新：黑方提掉角上的白子后与重新拍快照的结果一致
+    initBoard(&board);
+    const int moves[] = {VERTEX(1, 0), VERTEX(0, 0), VERTEX(0, 1)};
+    initPlayoutBoard(&pb, &board);
+    for (int i = 0; i < 3; i++) {
+        CHECK(placeStone(&board, moves[i]));
+        playoutPlay(&pb, moves[i]);
+    }
+    CHECK(board.board[corner] == EMPTY);
+    CHECK(playoutIsEye(&pb, corner, BLACK));
+    checkSame(&board, &pb);
+
+    freeBoard(&board);
+}
+
+int main(void) {
+    testEyes();
+    testPatterns();
+    testRandomGames();
+
+    if (failures > 0) {
+        printf("test_playout: %d 项检查失败\n", failures);
+        return 1;
+    }
+    printf("test_playout: 全部通过\n");
+    return 0;
+}
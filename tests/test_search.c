@@ -0,0 +1,150 @@
+/**
+ * @file test_search.c
+ * @brief 搜索回归测试：随机数生成器的可复现性，以及固定种子下单线程搜索的确定性
+ */
+
+// 测试程序使用自己的 main，不经过 SDL_main
+#define SDL_MAIN_HANDLED
+
+#include "../include/ai.h"
+#include "../include/rng.h"
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+/**
+ * @brief 同一种子和流编号产生相同的序列，不同的流互不相同，有界取值不越界
+ */
+static void testRngStreams(void) {
+    Rng a, b, c;
+    seedRng(&a, 12345, 0);
+    seedRng(&b, 12345, 0);
+    seedRng(&c, 12345, 1);
+
+    int sameStream = 0;
+    int otherStream = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t x = rngNext(&a);
+        if (x == rngNext(&b)) sameStream++;
+        if (x == rngNext(&c)) otherStream++;
+    }
+    CHECK(sameStream == 1000);
+    CHECK(otherStream == 0);
+
+    int bounds[] = {1, 2, 7, 19, 361, 1000000};
+    for (int i = 0; i < (int)(sizeof(bounds) / sizeof(bounds[0])); i++) {
+        bool hitZero = false;
+        bool hitTop = false;
+        for (int j = 0; j < 20000; j++) {
+            int r = rngBelow(&a, bounds[i]);
+            CHECK(r >= 0 && r < bounds[i]);
+            if (r == 0) hitZero = true;
+            if (r == bounds[i] - 1) hitTop = true;
+        }
+        if (bounds[i] <= 361) CHECK(hitZero && hitTop);
+    }
+}
+
+/**
+ * @brief 逐个节点比较两棵搜索树的落子、统计和形状（包括候选落子表中各条边的统计和已创建的子节点）
+ * @return 两棵树是否相同
+ */
+static bool sameTree(MCTSNode* a, MCTSNode* b) {
+    if (a->move != b->move || a->childrenCount != b->childrenCount) return false;
+    if (SDL_AtomicGet(&a->visits) != SDL_AtomicGet(&b->visits)) return false;
+
+    for (int i = 0; i < a->childrenCount; i++) {
+        MCTSChildren* x = a->children;
+        MCTSChildren* y = b->children;
+        if (x->moves[i] != y->moves[i] || (x->nodes[i] == NULL) != (y->nodes[i] == NULL)) return false;
+        if (x->visits[i] != y->visits[i] || x->wins[i] != y->wins[i]) return false;
+        if (x->amafVisits[i] != y->amafVisits[i]) return false;
+        if (x->nodes[i] && !sameTree(x->nodes[i], y->nodes[i])) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 用指定种子在给定局面上搜索一次
+ */
+static MCTSNode* searchOnce(NodeArena* arena, Board* board, uint64_t seed) {
+    AIConfig config;
+    initAIConfig(&config);
+    config.threadCount = 1;
+    config.timeLimit = 0;
+    config.simulationCount = 2000;
+    config.seed = seed;
+
+    resetNodeArena(arena);
+    MCTSNode* root = createRootNode(arena, board);
+    runMCTS(board, &config, arena, root);
+    return root;
+}
+
+/**
+ * @brief 固定种子、单线程、不限时间的搜索逐位可复现，换种子后结果不同
+ */
+static void testSearchDeterminism(void) {
+    Board board;
+    initBoard(&board);
+    int moves[] = {VERTEX(3, 3), VERTEX(15, 15), VERTEX(15, 3), VERTEX(3, 15), VERTEX(9, 9)};
+    for (int i = 0; i < (int)(sizeof(moves) / sizeof(moves[0])); i++) {
+        CHECK(placeStone(&board, moves[i]));
+    }
+
+    NodeArena first, second;
+    CHECK(initNodeArena(&first, 1 << 16));
+    CHECK(initNodeArena(&second, 1 << 16));
+
+    MCTSNode* a = searchOnce(&first, &board, 20240603u);
+    MCTSNode* b = searchOnce(&second, &board, 20240603u);
+    CHECK(SDL_AtomicGet(&a->visits) == 2000);
+    CHECK(sameTree(a, b));
+
+    b = searchOnce(&second, &board, 20240604u);
+    CHECK(!sameTree(a, b));
+
+    // 完整的选点流程（含开局和兜底的随机选择）同样可复现
+    AIConfig config;
+    initAIConfig(&config);
+    config.threadCount = 1;
+    config.timeLimit = 0;
+    config.seed = 7;
+
+    SearchTree treeA, treeB;
+    CHECK(initSearchTree(&treeA, &config));
+    CHECK(initSearchTree(&treeB, &config));
+    for (int i = 0; i < 3; i++) {
+        int moveA = findBestMove(&treeA, &board, &config);
+        int moveB = findBestMove(&treeB, &board, &config);
+        CHECK(moveA == moveB);
+        CHECK(isValidMove(&board, moveA));
+        if (moveA != moveB || !isValidMove(&board, moveA)) break;
+        placeStone(&board, moveA);
+    }
+
+    freeSearchTree(&treeA);
+    freeSearchTree(&treeB);
+    freeNodeArena(&first);
+    freeNodeArena(&second);
+    freeBoard(&board);
+}
+
+int main(void) {
+    testRngStreams();
+    testSearchDeterminism();
+
+    if (failures > 0) {
+        printf("test_search: %d 项检查失败\n", failures);
+        return 1;
+    }
+    printf("test_search: 全部通过\n");
+    return 0;
+}